@@ -76,6 +76,27 @@ void Board::draw(sf::RenderTarget& target, sf::RenderStates states) const {
                 markedOverlay.setPosition(sf::Vector2f(m_origin.x + col * m_tileSize, m_origin.y + row * m_tileSize));
                 target.draw(markedOverlay, states);
             }
+
+            // Threat map tint (attackers of either side)
+            if (m_showThreatMap && m_threatTints[row][col].a > 0) {
+                sf::RectangleShape tint({m_tileSize, m_tileSize});
+                tint.setFillColor(m_threatTints[row][col]);
+                tint.setPosition(sf::Vector2f(m_origin.x + col * m_tileSize, m_origin.y + row * m_tileSize));
+                target.draw(tint, states);
+            }
+        }
+    }
+
+    // Outline hanging pieces (attacked and undefended)
+    if (m_showThreatMap) {
+        const float thickness = std::max(2.f, m_tileSize * 0.06f);
+        for (const auto& [row, col] : m_hangingSquares) {
+            sf::RectangleShape outline({m_tileSize - 2.f * thickness, m_tileSize - 2.f * thickness});
+            outline.setFillColor(sf::Color::Transparent);
+            outline.setOutlineThickness(thickness);
+            outline.setOutlineColor(sf::Color(230, 30, 30, 220));
+            outline.setPosition(sf::Vector2f(m_origin.x + col * m_tileSize + thickness, m_origin.y + row * m_tileSize + thickness));
+            target.draw(outline, states);
         }
     }
 
@@ -235,6 +256,17 @@ bool Board::isSquareMarked(int row, int col) const {
     return std::find(m_markedSquares.begin(), m_markedSquares.end(), std::make_pair(row, col)) != m_markedSquares.end();
 }
 
+void Board::setThreatMap(const SquareTints& tints, const std::vector<std::pair<int, int>>& hanging) {
+    m_threatTints = tints;
+    m_hangingSquares = hanging;
+    m_showThreatMap = true;
+}
+
+void Board::clearThreatMap() {
+    m_showThreatMap = false;
+    m_hangingSquares.clear();
+}
+
 // Arrow management methods
 void Board::addArrow(int fromRow, int fromCol, int toRow, int toCol, const sf::Color& color) {
     // Check if arrow already exists (to avoid duplicates)
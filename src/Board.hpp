@@ -67,6 +67,12 @@ public:
     void clearArrows();
     void removeArrow(int fromRow, int fromCol, int toRow, int toCol);
 
+    // Threat map overlay: a tint per square (alpha 0 = none) and an outline around
+    // hanging pieces, drawn under the pieces
+    using SquareTints = std::array<std::array<sf::Color, 8>, 8>;
+    void setThreatMap(const SquareTints& tints, const std::vector<std::pair<int, int>>& hanging);
+    void clearThreatMap();
+
 private:
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
     void drawArrow(sf::RenderTarget& target, sf::RenderStates states, const Arrow& arrow) const;
@@ -90,4 +96,8 @@ private:
     std::vector<std::pair<int, int>> m_markedSquares;
     // arrows for drawing planned moves
     std::vector<Arrow> m_arrows;
+    // threat map overlay
+    bool m_showThreatMap = false;
+    SquareTints m_threatTints{};
+    std::vector<std::pair<int, int>> m_hangingSquares;
 };
@@ -0,0 +1,90 @@
+#include "AttackMap.hpp"
+
+using namespace Bitboards;
+
+Bitboard AttackMap::pieceAttacks(int piece, int sq, Bitboard occupied) {
+    switch (pieceType(piece)) {
+        case PieceType::PAWN:   return pawnAttacks(pieceColor(piece), sq);
+        case PieceType::KNIGHT: return knightAttacks(sq);
+        case PieceType::BISHOP: return bishopAttacks(sq, occupied);
+        case PieceType::ROOK:   return rookAttacks(sq, occupied);
+        case PieceType::QUEEN:  return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+        case PieceType::KING:   return kingAttacks(sq);
+        default:                return 0;
+    }
+}
+
+void AttackMap::add(int piece, int sq, Bitboard occupied) {
+    const int c = static_cast<int>(pieceColor(piece));
+    Bitboard attacks = pieceAttacks(piece, sq, occupied);
+    attacks_[sq] = attacks;
+    owner_[sq] = static_cast<std::uint8_t>(c);
+    const PieceType t = pieceType(piece);
+    if (t == PieceType::BISHOP || t == PieceType::ROOK || t == PieceType::QUEEN) sliders_ |= squareBB(sq);
+    while (attacks) ++counts_[c][popLsb(attacks)];
+}
+
+void AttackMap::remove(int sq) {
+    Bitboard attacks = attacks_[sq];
+    while (attacks) --counts_[owner_[sq]][popLsb(attacks)];
+    attacks_[sq] = 0;
+    sliders_ &= ~squareBB(sq);
+}
+
+void AttackMap::refreshAttackedBy() {
+    attackedBy_[0] = attackedBy_[1] = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (counts_[0][sq]) attackedBy_[0] |= squareBB(sq);
+        if (counts_[1][sq]) attackedBy_[1] |= squareBB(sq);
+    }
+}
+
+void AttackMap::build(const Position& pos) {
+    *this = AttackMap{};
+    const Bitboard occupied = pos.pieces();
+    Bitboard b = occupied;
+    while (b) {
+        const int sq = popLsb(b);
+        add(pos.pieceOn(sq), sq, occupied);
+    }
+    refreshAttackedBy();
+    lastRecomputed_ = popCount(occupied);
+}
+
+void AttackMap::update(const Position& before, const Position& after) {
+    // Squares whose contents differ: from, to, a captured pawn, a castling rook
+    Bitboard changed = 0;
+    for (int c = 0; c < 2; ++c) {
+        for (int t = 0; t < 6; ++t) {
+            const Color color = static_cast<Color>(c);
+            const PieceType type = static_cast<PieceType>(t);
+            changed |= before.pieces(color, type) ^ after.pieces(color, type);
+        }
+    }
+    if (!changed) return;
+
+    // Pieces on changed squares, and sliders whose rays reached one of them
+    Bitboard stale = changed & before.pieces();
+    Bitboard s = sliders_ & ~changed;
+    while (s) {
+        const int sq = popLsb(s);
+        if (attacks_[sq] & changed) stale |= squareBB(sq);
+    }
+
+    Bitboard b = stale;
+    while (b) remove(popLsb(b));
+
+    const Bitboard occupied = after.pieces();
+    Bitboard fresh = (stale | changed) & occupied;
+    lastRecomputed_ = popCount(fresh);
+    while (fresh) {
+        const int sq = popLsb(fresh);
+        add(after.pieceOn(sq), sq, occupied);
+    }
+    refreshAttackedBy();
+}
+
+Bitboard AttackMap::hanging(const Position& pos, Color c) const {
+    const Color them = opposite(c);
+    return pos.pieces(c) & ~pos.pieces(PieceType::KING) & attackedBy(them) & ~attackedBy(c);
+}
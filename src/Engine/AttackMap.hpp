@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.hpp"
+#include "Position.hpp"
+
+// Number of attackers of each colour on every square, for the threat-map
+// overlay. Built once, then kept up to date move by move: update() looks at
+// the squares whose contents changed and recomputes only the pieces standing
+// on them plus the sliders whose attacks reached one of them (the only
+// sliders a move can block or unblock). Everything else keeps its attacks.
+//
+// Attacks are pseudo-attacks as in Position::attackersTo: pinned pieces still
+// count, and pieces behind a slider of the same colour (batteries) do not.
+class AttackMap {
+public:
+    void build(const Position& pos);
+
+    // The map must describe before; afterwards it describes after. Works for any
+    // two positions, but is cheapest when they are one move apart.
+    void update(const Position& before, const Position& after);
+
+    int attackers(Color c, int sq) const { return counts_[static_cast<int>(c)][sq]; }
+
+    // Squares attacked by c at least once
+    Bitboard attackedBy(Color c) const { return attackedBy_[static_cast<int>(c)]; }
+
+    // Pieces of c (king excluded) that the other side attacks and c does not defend
+    Bitboard hanging(const Position& pos, Color c) const;
+
+    // Squares the last update() recomputed attacks for (all of them after build())
+    int lastRecomputed() const { return lastRecomputed_; }
+
+private:
+    static Bitboard pieceAttacks(int piece, int sq, Bitboard occupied);
+    void add(int piece, int sq, Bitboard occupied);
+    void remove(int sq);
+    void refreshAttackedBy();
+
+    Bitboard attacks_[64] = {};         // attacks of the piece on each square, 0 if empty
+    std::uint8_t owner_[64] = {};        // colour of that piece
+    std::uint8_t counts_[2][64] = {};
+    Bitboard attackedBy_[2] = {};
+    Bitboard sliders_ = 0;
+    int lastRecomputed_ = 0;
+};
@@ -0,0 +1,290 @@
+#include "BatchEval.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace Bitboards;
+
+namespace BatchEval {
+
+namespace {
+
+constexpr PieceType MOBILE_TYPES[4] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT};
+
+Bitboard typeAttacks(PieceType t, Bitboard pieces, Bitboard occupied) {
+    Bitboard attacks = 0;
+    while (pieces) {
+        const int sq = popLsb(pieces);
+        switch (t) {
+            case PieceType::KNIGHT: attacks |= knightAttacks(sq); break;
+            case PieceType::BISHOP: attacks |= bishopAttacks(sq, occupied); break;
+            case PieceType::ROOK:   attacks |= rookAttacks(sq, occupied); break;
+            default:                attacks |= bishopAttacks(sq, occupied) | rookAttacks(sq, occupied); break;
+        }
+    }
+    return attacks;
+}
+
+// Middlegame/endgame blend shared by both paths
+int blend(int mg, int eg, int phase, int sign) {
+    phase = std::min(phase, Psqt::MAX_PHASE);
+    return sign * ((mg * phase + eg * (Psqt::MAX_PHASE - phase)) / Psqt::MAX_PHASE);
+}
+
+// The reference evaluation of one position given as bitboards by piece code
+int evaluateScalar(const Bitboard (&pieces)[12], int sign, const Weights& w) {
+    Bitboard own[2] = {0, 0};
+    for (int pc = 0; pc < 12; ++pc) own[pc / 6] |= pieces[pc];
+    const Bitboard occupied = own[0] | own[1];
+
+    int mg = 0, eg = 0, phase = 0;
+    for (int pc = 0; pc < 12; ++pc) {
+        phase += Psqt::PHASE_WEIGHT[pc % 6] * popCount(pieces[pc]);
+        for (Bitboard b = pieces[pc]; b;) {
+            const Psqt::Score s = w.pieceSquare[pc][popLsb(b)];
+            mg += s.mg;
+            eg += s.eg;
+        }
+    }
+    for (int c = 0; c < 2; ++c) {
+        const int side = c == 0 ? 1 : -1;
+        for (PieceType t : MOBILE_TYPES) {
+            const int n = popCount(typeAttacks(t, pieces[c * 6 + static_cast<int>(t)], occupied) & ~own[c]);
+            mg += side * n * w.mobility[static_cast<int>(t)].mg;
+            eg += side * n * w.mobility[static_cast<int>(t)].eg;
+        }
+    }
+    return blend(mg, eg, phase, sign);
+}
+
+#if defined(__AVX2__)
+
+// Shift of four bitboards; positive S moves towards h1
+template <int S>
+__m256i shift(__m256i b) {
+    if constexpr (S > 0) return _mm256_slli_epi64(b, S);
+    else return _mm256_srli_epi64(b, -S);
+}
+
+// Set-wise slider attacks in the direction of S (Kogge-Stone fill). wrap is the
+// set of squares that can be entered without crossing the board edge.
+template <int S>
+__m256i slide(__m256i gen, __m256i empty, __m256i wrap) {
+    __m256i pro = _mm256_and_si256(empty, wrap);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift<S>(gen)));
+    pro = _mm256_and_si256(pro, shift<S>(pro));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift<2 * S>(gen)));
+    pro = _mm256_and_si256(pro, shift<2 * S>(pro));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift<4 * S>(gen)));
+    return _mm256_and_si256(shift<S>(gen), wrap);
+}
+
+struct Masks {
+    __m256i all = _mm256_set1_epi64x(-1);
+    __m256i notA = _mm256_set1_epi64x(static_cast<long long>(~colBB(0)));
+    __m256i notH = _mm256_set1_epi64x(static_cast<long long>(~colBB(7)));
+    __m256i notAB = _mm256_set1_epi64x(static_cast<long long>(~(colBB(0) | colBB(1))));
+    __m256i notGH = _mm256_set1_epi64x(static_cast<long long>(~(colBB(6) | colBB(7))));
+};
+
+__m256i orthogonal(__m256i gen, __m256i empty, const Masks& m) {
+    return _mm256_or_si256(_mm256_or_si256(slide<1>(gen, empty, m.notA), slide<-1>(gen, empty, m.notH)),
+                           _mm256_or_si256(slide<8>(gen, empty, m.all), slide<-8>(gen, empty, m.all)));
+}
+
+__m256i diagonal(__m256i gen, __m256i empty, const Masks& m) {
+    return _mm256_or_si256(_mm256_or_si256(slide<9>(gen, empty, m.notA), slide<7>(gen, empty, m.notH)),
+                           _mm256_or_si256(slide<-7>(gen, empty, m.notA), slide<-9>(gen, empty, m.notH)));
+}
+
+__m256i knights(__m256i n, const Masks& m) {
+    const __m256i one = _mm256_or_si256(_mm256_and_si256(shift<1>(n), m.notA), _mm256_and_si256(shift<-1>(n), m.notH));
+    const __m256i two = _mm256_or_si256(_mm256_and_si256(shift<2>(n), m.notAB), _mm256_and_si256(shift<-2>(n), m.notGH));
+    return _mm256_or_si256(_mm256_or_si256(shift<16>(one), shift<-16>(one)),
+                           _mm256_or_si256(shift<8>(two), shift<-8>(two)));
+}
+
+// Population count of each 64-bit lane (nibble lookup, then a byte sum per lane)
+__m256i popCount4(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, nibble));
+    const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+// Low 32 bits of four 64-bit lanes into four consecutive ints
+void storeLow32(std::int32_t* out, __m256i v) {
+    const __m256i packed = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+}
+
+// Byte tables for _mm256_shuffle_epi8: for each square and term (mg, eg) the
+// low and high bytes of the 16-bit score of every piece code, NO_PIECE giving 0
+struct alignas(32) ShuffleTables {
+    std::uint8_t bytes[64][2][2][32]; // [sq][mg/eg][low/high byte][piece code, repeated per 128-bit half]
+};
+
+void buildShuffleTables(const Weights& w, ShuffleTables& t) {
+    std::memset(&t, 0, sizeof(t));
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int pc = 0; pc < 12; ++pc) {
+            const std::uint16_t term[2] = {static_cast<std::uint16_t>(w.pieceSquare[pc][sq].mg),
+                                           static_cast<std::uint16_t>(w.pieceSquare[pc][sq].eg)};
+            for (int k = 0; k < 2; ++k) {
+                for (int half = 0; half < 2; ++half) {
+                    t.bytes[sq][k][0][half * 16 + pc] = static_cast<std::uint8_t>(term[k] & 0xFF);
+                    t.bytes[sq][k][1][half * 16 + pc] = static_cast<std::uint8_t>(term[k] >> 8);
+                }
+            }
+        }
+    }
+}
+
+__m256i loadTable(const std::uint8_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+
+// Piece-square sums of 32 lanes, as 16-bit mg and eg in lane order
+void pieceSquareKernel(const std::uint8_t (*board)[LANES], const ShuffleTables& t, std::int16_t* mg,
+                       std::int16_t* eg) {
+    // unpacklo/hi interleave within 128-bit halves: accumulators hold lanes
+    // 0-7 and 16-23 (lo) and 8-15 and 24-31 (hi); permuted back at the end
+    __m256i acc[2][2] = {{_mm256_setzero_si256(), _mm256_setzero_si256()},
+                         {_mm256_setzero_si256(), _mm256_setzero_si256()}};
+    for (int sq = 0; sq < 64; ++sq) {
+        const __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(board[sq]));
+        for (int k = 0; k < 2; ++k) {
+            const __m256i lo = _mm256_shuffle_epi8(loadTable(t.bytes[sq][k][0]), codes);
+            const __m256i hi = _mm256_shuffle_epi8(loadTable(t.bytes[sq][k][1]), codes);
+            acc[k][0] = _mm256_add_epi16(acc[k][0], _mm256_unpacklo_epi8(lo, hi));
+            acc[k][1] = _mm256_add_epi16(acc[k][1], _mm256_unpackhi_epi8(lo, hi));
+        }
+    }
+    std::int16_t* out[2] = {mg, eg};
+    for (int k = 0; k < 2; ++k) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out[k]), _mm256_permute2x128_si256(acc[k][0], acc[k][1], 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out[k] + 16),
+                            _mm256_permute2x128_si256(acc[k][0], acc[k][1], 0x31));
+    }
+}
+
+// Mobility and phase of four lanes starting at lane
+void mobilityKernel(const Bitboard (*pieces)[LANES], int lane, const Weights& w, const Masks& m, std::int32_t* mg,
+                    std::int32_t* eg, std::int32_t* phase) {
+    __m256i bb[12];
+    for (int pc = 0; pc < 12; ++pc) bb[pc] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pieces[pc] + lane));
+    __m256i own[2] = {_mm256_setzero_si256(), _mm256_setzero_si256()};
+    for (int pc = 0; pc < 12; ++pc) own[pc / 6] = _mm256_or_si256(own[pc / 6], bb[pc]);
+    const __m256i empty = _mm256_xor_si256(_mm256_or_si256(own[0], own[1]), m.all);
+
+    __m256i mgSum = _mm256_setzero_si256(), egSum = _mm256_setzero_si256(), phaseSum = _mm256_setzero_si256();
+    for (int t = 0; t < 6; ++t) {
+        const __m256i count = popCount4(_mm256_or_si256(bb[t], bb[6 + t]));
+        phaseSum = _mm256_add_epi64(phaseSum, _mm256_mul_epi32(count, _mm256_set1_epi64x(Psqt::PHASE_WEIGHT[t])));
+    }
+    for (int c = 0; c < 2; ++c) {
+        const int side = c == 0 ? 1 : -1;
+        for (PieceType t : MOBILE_TYPES) {
+            const __m256i gen = bb[c * 6 + static_cast<int>(t)];
+            __m256i attacks;
+            switch (t) {
+                case PieceType::KNIGHT: attacks = knights(gen, m); break;
+                case PieceType::BISHOP: attacks = diagonal(gen, empty, m); break;
+                case PieceType::ROOK:   attacks = orthogonal(gen, empty, m); break;
+                default:                attacks = _mm256_or_si256(diagonal(gen, empty, m), orthogonal(gen, empty, m)); break;
+            }
+            const __m256i count = popCount4(_mm256_andnot_si256(own[c], attacks));
+            const Psqt::Score s = w.mobility[static_cast<int>(t)];
+            mgSum = _mm256_add_epi64(mgSum, _mm256_mul_epi32(count, _mm256_set1_epi64x(side * s.mg)));
+            egSum = _mm256_add_epi64(egSum, _mm256_mul_epi32(count, _mm256_set1_epi64x(side * s.eg)));
+        }
+    }
+    storeLow32(mg + lane, mgSum);
+    storeLow32(eg + lane, egSum);
+    storeLow32(phase + lane, phaseSum);
+}
+
+// Tapered scores of eight lanes; the division goes through float, which is exact
+// here because |mg * phase + eg * (24 - phase)| stays far below 2^24
+__m256i blendKernel(__m256i mg, __m256i eg, __m256i phase, __m256i sign) {
+    const __m256i maxPhase = _mm256_set1_epi32(Psqt::MAX_PHASE);
+    phase = _mm256_min_epi32(phase, maxPhase);
+    const __m256i sum = _mm256_add_epi32(_mm256_mullo_epi32(mg, phase),
+                                         _mm256_mullo_epi32(eg, _mm256_sub_epi32(maxPhase, phase)));
+    const __m256 quotient = _mm256_div_ps(_mm256_cvtepi32_ps(sum), _mm256_set1_ps(static_cast<float>(Psqt::MAX_PHASE)));
+    return _mm256_sign_epi32(_mm256_cvttps_epi32(quotient), sign);
+}
+
+#endif
+
+} // namespace
+
+void PositionBatch::add(const Position& pos) {
+    const std::size_t lane = size_ % LANES;
+    if (lane == 0) {
+        blocks_.emplace_back();
+        Block& b = blocks_.back();
+        std::memset(b.board, NO_PIECE, sizeof(b.board));
+        std::memset(b.pieces, 0, sizeof(b.pieces));
+        std::fill(std::begin(b.sign), std::end(b.sign), 1);
+    }
+    Block& b = blocks_.back();
+    for (int sq = 0; sq < 64; ++sq) b.board[sq][lane] = static_cast<std::uint8_t>(pos.pieceOn(sq));
+    for (int pc = 0; pc < 12; ++pc) b.pieces[pc][lane] = pos.pieces(pieceColor(pc), pieceType(pc));
+    b.sign[lane] = pos.sideToMove() == Color::WHITE ? 1 : -1;
+    ++size_;
+}
+
+void PositionBatch::clear() {
+    blocks_.clear();
+    size_ = 0;
+}
+
+int evaluate(const Position& pos, const Weights& weights) {
+    Bitboard pieces[12];
+    for (int pc = 0; pc < 12; ++pc) pieces[pc] = pos.pieces(pieceColor(pc), pieceType(pc));
+    return evaluateScalar(pieces, pos.sideToMove() == Color::WHITE ? 1 : -1, weights);
+}
+
+void evaluate(const PositionBatch& batch, const Weights& weights, int* scores) {
+#if defined(__AVX2__)
+    // Built once per call: 8 KB, small next to a batch of thousands of positions
+    static thread_local ShuffleTables tables;
+    buildShuffleTables(weights, tables);
+    const Masks masks;
+#endif
+
+    for (std::size_t block = 0; block < batch.blocks_.size(); ++block) {
+        const PositionBatch::Block& b = batch.blocks_[block];
+        const std::size_t first = block * LANES;
+        const int lanes = static_cast<int>(std::min<std::size_t>(LANES, batch.size_ - first));
+
+#if defined(__AVX2__)
+        alignas(32) std::int16_t psqMg[LANES], psqEg[LANES];
+        alignas(32) std::int32_t mobMg[LANES], mobEg[LANES], phase[LANES], out[LANES];
+        pieceSquareKernel(b.board, tables, psqMg, psqEg);
+        for (int lane = 0; lane < LANES; lane += 4) mobilityKernel(b.pieces, lane, weights, masks, mobMg, mobEg, phase);
+        for (int lane = 0; lane < LANES; lane += 8) {
+            auto load32 = [&](const std::int32_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p + lane)); };
+            auto load16 = [&](const std::int16_t* p) {
+                return _mm256_cvtepi16_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(p + lane)));
+            };
+            const __m256i mg = _mm256_add_epi32(load16(psqMg), load32(mobMg));
+            const __m256i eg = _mm256_add_epi32(load16(psqEg), load32(mobEg));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out + lane), blendKernel(mg, eg, load32(phase), load32(b.sign)));
+        }
+        std::copy(out, out + lanes, scores + first);
+#else
+        for (int lane = 0; lane < lanes; ++lane) {
+            Bitboard pieces[12];
+            for (int pc = 0; pc < 12; ++pc) pieces[pc] = b.pieces[pc][lane];
+            scores[first + lane] = evaluateScalar(pieces, b.sign[lane], weights);
+        }
+#endif
+    }
+}
+
+} // namespace BatchEval
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Position.hpp"
+#include "Psqt.hpp"
+
+// Static evaluation of many independent positions at once, for offline jobs
+// (tuners, dataset filters, analysers) that score millions of positions.
+//
+// The evaluation is material + piece-square (Psqt) + mobility, tapered by game
+// phase like evaluate(), with every weight in a Weights struct so a tuner can
+// vary them between passes. Mobility is set-wise: the number of squares not
+// holding an own piece that the knights (bishops, rooks, queens) of a side
+// attack together. Pawn structure, KPK and the network are not part of it.
+//
+// PositionBatch stores positions structure-of-arrays in blocks of LANES: for
+// every square the piece codes of all lanes side by side, and for every piece
+// code the bitboards of all lanes side by side. With AVX2 the piece-square sum
+// is a byte shuffle per square for 32 positions, mobility is Kogge-Stone
+// attack fills on four bitboards per instruction, and the blend works on eight
+// scores per instruction. Without AVX2 each lane goes through the scalar code,
+// which gives the same numbers as evaluate(pos, weights).
+namespace BatchEval {
+
+constexpr int LANES = 32;
+
+struct Weights {
+    Psqt::PieceTable pieceSquare = Psqt::PIECE_SQUARE; // material + placement, signed from White's view
+    // Per square attacked, by PieceType; kings and pawns are not counted
+    Psqt::Score mobility[6] = {{0, 0}, {1, 2}, {2, 4}, {5, 5}, {4, 4}, {0, 0}};
+};
+
+class PositionBatch {
+public:
+    void add(const Position& pos);
+    void clear();
+    std::size_t size() const { return size_; }
+
+private:
+    friend void evaluate(const PositionBatch& batch, const Weights& weights, int* scores);
+
+    struct alignas(32) Block {
+        std::uint8_t board[64][LANES];  // piece code per square, NO_PIECE when empty
+        Bitboard pieces[12][LANES];     // by piece code
+        std::int32_t sign[LANES];       // +1 White to move, -1 Black
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t size_ = 0;
+};
+
+// Centipawns from the side to move's point of view. Piece-square sums must fit
+// in 16 bits, which holds for any legal position with centipawn weights.
+int evaluate(const Position& pos, const Weights& weights);
+
+// scores[i] = evaluate(i-th position added, weights); scores holds batch.size() entries
+void evaluate(const PositionBatch& batch, const Weights& weights, int* scores);
+
+} // namespace BatchEval
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "../Pieces/Piece.hpp"
+
+// 64-bit square sets used by the search engine.
+// Squares are numbered like GameLogic's grid: index = row * 8 + col,
+// so a8 = 0, h8 = 7, a1 = 56 and h1 = 63. White pawns move towards row 0.
+using Bitboard = std::uint64_t;
+
+constexpr int NO_SQUARE = -1;
+
+constexpr int squareOf(int row, int col) { return row * 8 + col; }
+constexpr int rowOf(int sq) { return sq >> 3; }
+constexpr int colOf(int sq) { return sq & 7; }
+constexpr Bitboard squareBB(int sq) { return Bitboard(1) << sq; }
+
+constexpr Bitboard ROW_BB[8] = {
+    0xFFULL,       0xFFULL << 8,  0xFFULL << 16, 0xFFULL << 24,
+    0xFFULL << 32, 0xFFULL << 40, 0xFFULL << 48, 0xFFULL << 56
+};
+constexpr Bitboard COL_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard colBB(int col) { return COL_A_BB << col; }
+
+// Mirror a square vertically (a8 <-> a1); used to read tables from Black's side
+constexpr int flipRow(int sq) { return sq ^ 56; }
+
+inline Color opposite(Color c) { return c == Color::WHITE ? Color::BLACK : Color::WHITE; }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+inline int popLsb(Bitboard& b) {
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+namespace Bitboards {
+
+// Ray directions. Directions 0-3 grow the square index, 4-7 shrink it.
+enum Direction { EAST, SOUTH, SOUTH_EAST, SOUTH_WEST, WEST, NORTH, NORTH_WEST, NORTH_EAST };
+
+constexpr int DIR_ROW[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+constexpr int DIR_COL[8] = {1, 0, 1, -1, -1, 0, -1, 1};
+
+using SquareTable = std::array<Bitboard, 64>;
+
+constexpr Bitboard stepTargets(int sq, const int (&dr)[8], const int (&dc)[8]) {
+    Bitboard b = 0;
+    for (int i = 0; i < 8; ++i) {
+        int r = rowOf(sq) + dr[i];
+        int c = colOf(sq) + dc[i];
+        if (r >= 0 && r < 8 && c >= 0 && c < 8) b |= squareBB(squareOf(r, c));
+    }
+    return b;
+}
+
+constexpr SquareTable makeKnightTable() {
+    constexpr int dr[8] = {-2, -2, -1, -1, 1, 1, 2, 2};
+    constexpr int dc[8] = {-1, 1, -2, 2, -2, 2, -1, 1};
+    SquareTable t{};
+    for (int sq = 0; sq < 64; ++sq) t[sq] = stepTargets(sq, dr, dc);
+    return t;
+}
+
+constexpr SquareTable makeKingTable() {
+    SquareTable t{};
+    for (int sq = 0; sq < 64; ++sq) t[sq] = stepTargets(sq, DIR_ROW, DIR_COL);
+    return t;
+}
+
+constexpr SquareTable makePawnTable(int forward) {
+    SquareTable t{};
+    for (int sq = 0; sq < 64; ++sq) {
+        int r = rowOf(sq) + forward;
+        if (r < 0 || r > 7) continue;
+        if (colOf(sq) > 0) t[sq] |= squareBB(squareOf(r, colOf(sq) - 1));
+        if (colOf(sq) < 7) t[sq] |= squareBB(squareOf(r, colOf(sq) + 1));
+    }
+    return t;
+}
+
+constexpr std::array<SquareTable, 8> makeRayTable() {
+    std::array<SquareTable, 8> t{};
+    for (int d = 0; d < 8; ++d) {
+        for (int sq = 0; sq < 64; ++sq) {
+            int r = rowOf(sq) + DIR_ROW[d];
+            int c = colOf(sq) + DIR_COL[d];
+            while (r >= 0 && r < 8 && c >= 0 && c < 8) {
+                t[d][sq] |= squareBB(squareOf(r, c));
+                r += DIR_ROW[d];
+                c += DIR_COL[d];
+            }
+        }
+    }
+    return t;
+}
+
+inline constexpr SquareTable KNIGHT_ATTACKS = makeKnightTable();
+inline constexpr SquareTable KING_ATTACKS = makeKingTable();
+// PAWN_ATTACKS[color][sq]: squares a pawn of that color on sq attacks
+inline constexpr std::array<SquareTable, 2> PAWN_ATTACKS = {makePawnTable(-1), makePawnTable(1)};
+inline constexpr std::array<SquareTable, 8> RAYS = makeRayTable();
+
+// Attacks along one ray, stopping at (and including) the first blocker
+inline Bitboard rayAttacks(int dir, int sq, Bitboard occupied) {
+    Bitboard attacks = RAYS[dir][sq];
+    Bitboard blockers = attacks & occupied;
+    if (blockers) {
+        int blocker = dir < 4 ? lsb(blockers) : msb(blockers);
+        attacks ^= RAYS[dir][blocker];
+    }
+    return attacks;
+}
+
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    return rayAttacks(EAST, sq, occupied) | rayAttacks(SOUTH, sq, occupied) |
+           rayAttacks(WEST, sq, occupied) | rayAttacks(NORTH, sq, occupied);
+}
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    return rayAttacks(SOUTH_EAST, sq, occupied) | rayAttacks(SOUTH_WEST, sq, occupied) |
+           rayAttacks(NORTH_WEST, sq, occupied) | rayAttacks(NORTH_EAST, sq, occupied);
+}
+
+inline Bitboard knightAttacks(int sq) { return KNIGHT_ATTACKS[sq]; }
+inline Bitboard kingAttacks(int sq) { return KING_ATTACKS[sq]; }
+inline Bitboard pawnAttacks(Color c, int sq) { return PAWN_ATTACKS[static_cast<int>(c)][sq]; }
+
+// Squares strictly between a and b when they share a row, column or diagonal; 0 otherwise
+inline Bitboard between(int a, int b) {
+    for (int d = 0; d < 8; ++d) {
+        if (RAYS[d][a] & squareBB(b)) return RAYS[d][a] & ~RAYS[d][b] & ~squareBB(b);
+    }
+    return 0;
+}
+
+} // namespace Bitboards
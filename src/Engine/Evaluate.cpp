@@ -0,0 +1,94 @@
+#include "Evaluate.hpp"
+#include "Psqt.hpp"
+#include "Kpk.hpp"
+#include <algorithm>
+
+namespace {
+
+// Extra endgame bonus for a passed pawn whose next square is empty, by relative rank
+constexpr int FREE_PASSER_EG[8] = {0, 0, 5, 10, 20, 35, 60, 0};
+
+// King + pawn vs king is decided by the bitbase: a draw is exactly 0, a win
+// stays below the value of the queen so the search still wants to promote
+constexpr int KPK_WIN = 400;
+constexpr int KPK_WIN_PER_RANK = 20;
+
+// Chess960: a bishop in a corner of its home row with an own pawn on the
+// diagonal square in front is out of play, and more so if that pawn is blocked
+constexpr int CORNERED_BISHOP = 50;
+
+int corneredBishops(const Position& pos) {
+    int score = 0;
+    for (Color c : {Color::WHITE, Color::BLACK}) {
+        const int sign = c == Color::WHITE ? 1 : -1;
+        const int forward = c == Color::WHITE ? -8 : 8;
+        const Bitboard bishops = pos.pieces(c, PieceType::BISHOP);
+        const Bitboard pawns = pos.pieces(c, PieceType::PAWN);
+        const int home = c == Color::WHITE ? 7 : 0;
+        for (int col : {0, 7}) {
+            const int corner = squareOf(home, col);
+            const int blocker = corner + forward + (col == 0 ? 1 : -1);
+            if (!(bishops & squareBB(corner)) || !(pawns & squareBB(blocker))) continue;
+            const bool stuck = pos.pieceOn(blocker + forward) != NO_PIECE;
+            score -= sign * (stuck ? 2 * CORNERED_BISHOP : CORNERED_BISHOP);
+        }
+    }
+    return score;
+}
+
+int evaluateKpk(const Position& pos) {
+    const int pawn = lsb(pos.pieces(PieceType::PAWN));
+    const Color strong = pieceColor(pos.pieceOn(pawn));
+    const Color weak = opposite(strong);
+    if (!Kpk::probe(strong, pos.kingSquare(strong), pawn, pos.kingSquare(weak), pos.sideToMove())) return 0;
+
+    const int rank = strong == Color::WHITE ? 7 - rowOf(pawn) : rowOf(pawn);
+    const int score = KPK_WIN + KPK_WIN_PER_RANK * rank;
+    return pos.sideToMove() == strong ? score : -score;
+}
+
+Psqt::Score pawnStructure(const Position& pos, PawnTable& pawns) {
+    PawnEntry& entry = pawns.probe(pos);
+    Psqt::Score score = entry.score;
+    score.mg += pawns.shelter(pos, entry, Color::WHITE) - pawns.shelter(pos, entry, Color::BLACK);
+
+    const Bitboard occupied = pos.pieces();
+    for (Bitboard b = entry.passed[static_cast<int>(Color::WHITE)]; b;) {
+        int sq = popLsb(b);
+        if (!(occupied & squareBB(sq - 8))) score.eg += FREE_PASSER_EG[7 - rowOf(sq)];
+    }
+    for (Bitboard b = entry.passed[static_cast<int>(Color::BLACK)]; b;) {
+        int sq = popLsb(b);
+        if (!(occupied & squareBB(sq + 8))) score.eg -= FREE_PASSER_EG[rowOf(sq)];
+    }
+    return score;
+}
+
+} // namespace
+
+int evaluate(const Position& pos, PawnTable& pawns) {
+    // The bitbase covers pawns on ranks 2-7; a Diagonal chess pawn that never
+    // left its own first rank gets the normal evaluation
+    constexpr Bitboard KPK_PAWN_ROWS = ~(ROW_BB[0] | ROW_BB[7]);
+    if (popCount(pos.pieces()) == 3 && (pos.pieces(PieceType::PAWN) & KPK_PAWN_ROWS)) return evaluateKpk(pos);
+
+    // The network learns from self-play in the standard setup; Diagonal chess
+    // openings never occur there, so that variant keeps its own tables (Psqt.hpp)
+    if (Nnue::isLoaded() && pos.variant() != Variant::DIAGONAL) return Nnue::evaluate(pos.accumulator(), pos.sideToMove());
+
+    const Psqt::Score pawnScore = pawnStructure(pos, pawns);
+    const int bishops = pos.isChess960() ? corneredBishops(pos) : 0;
+    const int mg = pos.psqMg() + pawnScore.mg + bishops;
+    const int eg = pos.psqEg() + pawnScore.eg + bishops;
+
+    // Blend the middlegame and endgame sums by how much material is left;
+    // promotions can push the phase past its starting value
+    const int phase = std::min(pos.phase(), Psqt::MAX_PHASE);
+    int score = (mg * phase + eg * (Psqt::MAX_PHASE - phase)) / Psqt::MAX_PHASE;
+    return pos.sideToMove() == Color::WHITE ? score : -score;
+}
+
+int evaluate(const Position& pos) {
+    thread_local PawnTable pawns(1024);
+    return evaluate(pos, pawns);
+}
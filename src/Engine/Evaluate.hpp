@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Position.hpp"
+#include "PawnTable.hpp"
+
+// Material values in centipawns, indexed by PieceType (KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN)
+constexpr int PIECE_VALUE[6] = {0, 900, 500, 300, 300, 100};
+
+inline int pieceValue(PieceType t) { return t == PieceType::EMPTY ? 0 : PIECE_VALUE[static_cast<int>(t)]; }
+
+// Tapered material + piece-square + pawn-structure evaluation in centipawns from
+// the side to move's point of view, or the neural network when one is loaded.
+// Piece-square sums and the network accumulator are maintained incrementally by
+// Position and pawn terms come from the pawn hash, so evaluation never scans the board.
+int evaluate(const Position& pos, PawnTable& pawns);
+
+// Same, using a small per-thread pawn table (for callers outside the search)
+int evaluate(const Position& pos);
@@ -0,0 +1,238 @@
+#include "GameAnalyzer.hpp"
+#include "Search.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Beyond this a position is decided; mates and huge material edges compare equal
+constexpr int EVAL_CAP = 1000;
+
+int capped(int score) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return EVAL_CAP;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return -EVAL_CAP;
+    return std::clamp(score, -EVAL_CAP, EVAL_CAP);
+}
+
+MoveJudgement judge(int loss) {
+    if (loss >= BLUNDER_LOSS) return MoveJudgement::BLUNDER;
+    if (loss >= MISTAKE_LOSS) return MoveJudgement::MISTAKE;
+    if (loss >= INACCURACY_LOSS) return MoveJudgement::INACCURACY;
+    return MoveJudgement::NONE;
+}
+
+const char* judgementMark(MoveJudgement j) {
+    switch (j) {
+        case MoveJudgement::INACCURACY: return "?!";
+        case MoveJudgement::MISTAKE:    return "?";
+        case MoveJudgement::BLUNDER:    return "??";
+        default:                        return "";
+    }
+}
+
+// Score from White's point of view: +1.25, -0.40, #3, #-2 (# alone: mate on the board)
+std::string formatScore(int score, bool whiteView) {
+    if (!whiteView) score = -score;
+    if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY) {
+        const int moves = (VALUE_MATE - std::abs(score) + 1) / 2;
+        if (moves == 0) return "#";
+        return "#" + std::to_string(score > 0 ? moves : -moves);
+    }
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "%+.2f", score / 100.0);
+    return buf;
+}
+
+std::string count(int n, const char* one, const char* many) {
+    return std::to_string(n) + " " + (n == 1 ? one : many);
+}
+
+} // namespace
+
+GameAnalyzer::GameAnalyzer(int threads, std::uint64_t nodesPerPosition)
+    : threads_(threads), nodes_(nodesPerPosition) {
+    if (threads_ <= 0) threads_ = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    thread_ = std::thread([this] { run(); });
+}
+
+GameAnalyzer::~GameAnalyzer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+void GameAnalyzer::submit(AnalysisJob job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(job));
+        ++pending_;
+    }
+    cv_.notify_all();
+}
+
+void GameAnalyzer::run() {
+    for (;;) {
+        AnalysisJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return quit_ || !queue_.empty(); });
+            if (quit_) return;
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        process(job);
+        --pending_;
+    }
+}
+
+void GameAnalyzer::process(const AnalysisJob& job) {
+    Position start;
+    if (job.startFen.empty() || !start.setFromFen(job.startFen, job.variant)) {
+        std::cout << "Analysis skipped (variant not supported by the engine): " << job.gamePath << std::endl;
+        return;
+    }
+
+    const std::vector<AnalyzedPly> plies = analyze(start, job.moves);
+    if (quit_) return;
+
+    const fs::path source(job.gamePath);
+    const fs::path target = source.parent_path() / (source.stem().string() + "_analysis.txt");
+    std::ofstream file(target);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << target.string() << " for writing.\n";
+        return;
+    }
+    file << format(start, plies, nodes_);
+    std::cout << "Analysis saved to: " << target.string() << std::endl;
+}
+
+EngineMove GameAnalyzer::findMove(const Position& pos, const Move& move) {
+    MoveList list;
+    pos.legalMoves(list);
+    for (EngineMove m : list) {
+        const Move gm = pos.toGameMove(m);
+        if (gm.r1 != move.r1 || gm.c1 != move.c1 || gm.isCastling != move.isCastling) continue;
+        // GameLogic records castling by king or rook square depending on the variant
+        if (move.isCastling) {
+            if ((gm.c2 > gm.c1) == (move.c2 > move.c1)) return m;
+            continue;
+        }
+        if (gm.r2 != move.r2 || gm.c2 != move.c2) continue;
+        if (gm.isPromotion && gm.promotionPiece != move.promotionPiece) continue;
+        return m;
+    }
+    return NO_MOVE;
+}
+
+std::vector<AnalyzedPly> GameAnalyzer::analyze(const Position& start, const std::vector<Move>& moves) {
+    // Replay first: positions[i] is the position before move i, plus the final one
+    std::vector<Position> positions{start};
+    std::vector<EngineMove> played;
+    for (const Move& move : moves) {
+        Position next = positions.back();
+        const EngineMove m = findMove(next, move);
+        if (m == NO_MOVE) break;
+        next.doMove(m);
+        positions.push_back(next);
+        played.push_back(m);
+    }
+
+    // Every position on its own: workers take the next unsearched index
+    std::vector<SearchResult> results(positions.size());
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        Search search;
+        SearchLimits limits;
+        limits.nodes = nodes_;
+        for (std::size_t i = next++; i < positions.size() && !quit_; i = next++) {
+            MoveList legal;
+            positions[i].legalMoves(legal);
+            if (legal.size == 0) {
+                results[i].score = positions[i].inCheck() ? -VALUE_MATE : 0;
+                continue;
+            }
+            // Nothing carries over from the positions this worker searched before, so a
+            // score does not depend on the thread count or on which worker took it
+            search.clear();
+            results[i] = search.think(positions[i], limits);
+        }
+    };
+    std::vector<std::thread> pool;
+    const int workers = std::min<int>(threads_, static_cast<int>(positions.size()));
+    for (int t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    std::vector<AnalyzedPly> plies(played.size());
+    for (std::size_t i = 0; i < played.size(); ++i) {
+        AnalyzedPly& ply = plies[i];
+        ply.played = played[i];
+        ply.best = results[i].bestMove;
+        ply.bestScore = results[i].score;
+        ply.playedScore = -results[i + 1].score;
+        // Search noise between two runs must not mark the engine's own choice
+        if (ply.played != ply.best) ply.loss = std::max(0, capped(ply.bestScore) - capped(ply.playedScore));
+        ply.judgement = judge(ply.loss);
+    }
+    return plies;
+}
+
+std::string GameAnalyzer::format(const Position& start, const std::vector<AnalyzedPly>& plies,
+                                 std::uint64_t nodesPerPosition) {
+    std::ostringstream out;
+    out << "Analysis: " << nodesPerPosition << " nodes per position, evaluations from White's view\n\n";
+
+    int counts[2][4] = {};
+    long long totalLoss[2] = {};
+    int moveCount[2] = {};
+
+    Position pos = start;
+    int moveNumber = pos.gamePly() / 2 + 1;
+    for (std::size_t i = 0; i < plies.size(); ++i) {
+        const AnalyzedPly& ply = plies[i];
+        const bool white = pos.sideToMove() == Color::WHITE;
+        const int side = white ? 0 : 1;
+
+        if (white) out << moveNumber << ". ";
+        else if (i == 0) out << moveNumber << "... ";
+        out << pos.toSan(ply.played) << judgementMark(ply.judgement) << " {" << formatScore(ply.playedScore, white);
+        if (ply.judgement != MoveJudgement::NONE) {
+            out << "; best " << pos.toSan(ply.best) << " " << formatScore(ply.bestScore, white);
+        }
+        out << "}";
+
+        ++counts[side][static_cast<int>(ply.judgement)];
+        totalLoss[side] += ply.loss;
+        ++moveCount[side];
+
+        pos.doMove(ply.played);
+        if (!white) {
+            out << "\n";
+            ++moveNumber;
+        } else if (i + 1 < plies.size()) {
+            out << " ";
+        }
+    }
+    if (pos.sideToMove() == Color::BLACK) out << "\n";
+
+    out << "\n";
+    for (int side = 0; side < 2; ++side) {
+        const int* c = counts[side];
+        out << (side == 0 ? "White: " : "Black: ")
+            << count(c[static_cast<int>(MoveJudgement::INACCURACY)], "inaccuracy", "inaccuracies") << ", "
+            << count(c[static_cast<int>(MoveJudgement::MISTAKE)], "mistake", "mistakes") << ", "
+            << count(c[static_cast<int>(MoveJudgement::BLUNDER)], "blunder", "blunders")
+            << ", average loss " << (moveCount[side] ? totalLoss[side] / moveCount[side] : 0) << " cp\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Position.hpp"
+
+// Post-game review of recorded games, run in the background so the GUI is
+// never blocked by it.
+//
+// The moves of a finished game are replayed from its start position and every
+// position is searched with the same node budget (so a review does not depend
+// on the machine or on what else is running). Positions are independent and
+// are handed out to a pool of worker threads, each with its own Search that is
+// cleared before every position. The loss of a move is how much the mover's
+// evaluation drops from the best move to the move played; large losses are
+// marked ?!, ? or ??. The annotated game is written next to the original file
+// as <name>_analysis.txt.
+
+enum class MoveJudgement { NONE, INACCURACY, MISTAKE, BLUNDER };
+
+// Centipawn losses from which a move is marked (evaluations capped at +-1000)
+constexpr int INACCURACY_LOSS = 50;
+constexpr int MISTAKE_LOSS = 100;
+constexpr int BLUNDER_LOSS = 300;
+
+struct AnalysisJob {
+    std::string startFen;           // empty: variant the engine cannot replay
+    Variant variant = Variant::STANDARD;
+    std::vector<Move> moves;        // as recorded by GameRecorder
+    std::string gamePath;           // the saved game; the analysis goes next to it
+};
+
+struct AnalyzedPly {
+    EngineMove played = NO_MOVE;
+    EngineMove best = NO_MOVE;
+    int bestScore = 0;              // before the move, side to move's view
+    int playedScore = 0;            // after the move, the mover's view
+    int loss = 0;                   // centipawns, capped evaluations
+    MoveJudgement judgement = MoveJudgement::NONE;
+};
+
+class GameAnalyzer {
+public:
+    static constexpr std::uint64_t DEFAULT_NODES = 200000; // per position
+
+    // threads = 0: all cores but one, which is left to the GUI and the bot
+    explicit GameAnalyzer(int threads = 0, std::uint64_t nodesPerPosition = DEFAULT_NODES);
+    ~GameAnalyzer();
+
+    GameAnalyzer(const GameAnalyzer&) = delete;
+    GameAnalyzer& operator=(const GameAnalyzer&) = delete;
+
+    // Queue a game and return at once; games are analysed one after another
+    void submit(AnalysisJob job);
+
+    // A game is queued or being analysed
+    bool busy() const { return pending_ > 0; }
+
+    // Synchronous review (used by the background thread): one entry per move that
+    // could be replayed, stopping at the first move that is not legal in pos
+    std::vector<AnalyzedPly> analyze(const Position& start, const std::vector<Move>& moves);
+
+    // Annotated move list with a per-side summary, in GameRecorder's layout
+    static std::string format(const Position& start, const std::vector<AnalyzedPly>& plies,
+                              std::uint64_t nodesPerPosition);
+
+    // Engine move of pos matching a move recorded by GameLogic, or NO_MOVE
+    static EngineMove findMove(const Position& pos, const Move& move);
+
+private:
+    void run();
+    void process(const AnalysisJob& job);
+
+    int threads_;
+    std::uint64_t nodes_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<AnalysisJob> queue_;
+    std::atomic<int> pending_{0};
+    std::atomic<bool> quit_{false};
+};
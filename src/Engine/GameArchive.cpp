@@ -0,0 +1,155 @@
+#include "GameArchive.hpp"
+#include "../GameLogic.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+bool isGameFile(const fs::path& p) {
+    const std::string name = p.filename().string();
+    const std::string suffix = "_analysis.txt";
+    if (p.extension() != ".txt") return false;
+    return name.size() < suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0;
+}
+
+// White's half points, -1 if the token is not a result
+int parseResult(const std::string& token) {
+    if (token.rfind("1-0", 0) == 0) return 2;
+    if (token.rfind("0-1", 0) == 0) return 0;
+    if (token.rfind("1/2-1/2", 0) == 0) return 1;
+    return -1;
+}
+
+} // namespace
+
+std::map<std::string, std::vector<fs::path>> listArchive(const fs::path& dir) {
+    std::map<std::string, std::vector<fs::path>> byVariant;
+    if (!fs::is_directory(dir)) return byVariant;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && isGameFile(entry.path())) {
+            byVariant["standard"].push_back(entry.path());
+        } else if (entry.is_directory()) {
+            for (const auto& file : fs::directory_iterator(entry.path())) {
+                if (file.is_regular_file() && isGameFile(file.path()))
+                    byVariant[entry.path().filename().string()].push_back(file.path());
+            }
+        }
+    }
+    // Directory order is unspecified; sorted lists keep tool output reproducible
+    for (auto& [variant, files] : byVariant) std::sort(files.begin(), files.end());
+    return byVariant;
+}
+
+bool readArchivedGame(const fs::path& file, ArchivedGame& game) {
+    std::ifstream in(file);
+    if (!in) return false;
+    game = ArchivedGame{};
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("FEN: ", 0) == 0) {
+            game.startFen = line.substr(5);
+            continue;
+        }
+        std::istringstream is(line);
+        std::string token;
+        while (is >> token) {
+            if (token == "Reason:") return true;
+            if (parseResult(token) >= 0 || token == "*") {
+                game.result = parseResult(token);
+                return true;
+            }
+            if (std::isdigit(static_cast<unsigned char>(token[0])) && token.back() == '.') continue;
+            game.moves.push_back(token);
+        }
+    }
+    return true;
+}
+
+Variant archivedVariant(const std::string& variant) {
+    if (variant == "fischer") return Variant::CHESS960;
+    if (variant == "diagonal") return Variant::DIAGONAL;
+    return Variant::STANDARD;
+}
+
+bool archivedStartPosition(const std::string& variant, const ArchivedGame& game, Position& pos) {
+    if (!game.startFen.empty()) return pos.setFromFen(game.startFen, archivedVariant(variant));
+    GameLogic logic;
+    if (variant == "standard") logic.setup();
+    else if (variant == "diagonal") logic.setupDiagonal();
+    else return false;
+    pos.setFromGame(logic);
+    return true;
+}
+
+EngineMove parseRecordedMove(const Position& pos, std::string san) {
+    while (!san.empty() && (san.back() == '+' || san.back() == '#')) san.pop_back();
+
+    MoveList legal;
+    pos.legalMoves(legal);
+
+    if (san == "O-O" || san == "O-O-O") {
+        const bool kingSide = san == "O-O";
+        for (EngineMove m : legal) {
+            if (moveKind(m) == MoveKind::CASTLING && (colOf(moveTo(m)) > colOf(moveFrom(m))) == kingSide) return m;
+        }
+        return NO_MOVE;
+    }
+
+    PieceType type = PieceType::PAWN;
+    std::size_t i = 0;
+    switch (san.empty() ? ' ' : san[0]) {
+        case 'K': type = PieceType::KING; ++i; break;
+        case 'Q': type = PieceType::QUEEN; ++i; break;
+        case 'R': type = PieceType::ROOK; ++i; break;
+        case 'B': type = PieceType::BISHOP; ++i; break;
+        case 'N': type = PieceType::KNIGHT; ++i; break;
+        default: break;
+    }
+
+    int fromCol = -1;
+    bool capture = false;
+    if (type == PieceType::PAWN && i + 1 < san.size() && san[i + 1] == 'x') {
+        fromCol = san[i] - 'a';
+        i += 2;
+        capture = true;
+    } else if (i < san.size() && san[i] == 'x') {
+        ++i;
+        capture = true;
+    }
+    if (i + 2 > san.size() || san[i] < 'a' || san[i] > 'h' || san[i + 1] < '1' || san[i + 1] > '8') return NO_MOVE;
+    const int to = squareOf('8' - san[i + 1], san[i] - 'a');
+    i += 2;
+
+    PieceType promo = PieceType::EMPTY;
+    if (i + 1 < san.size() && san[i] == '=') {
+        switch (san[i + 1]) {
+            case 'Q': promo = PieceType::QUEEN; break;
+            case 'R': promo = PieceType::ROOK; break;
+            case 'B': promo = PieceType::BISHOP; break;
+            case 'N': promo = PieceType::KNIGHT; break;
+            default: return NO_MOVE;
+        }
+    }
+
+    std::vector<EngineMove> candidates;
+    for (EngineMove m : legal) {
+        if (moveKind(m) == MoveKind::CASTLING || moveTo(m) != to) continue;
+        if (pieceType(pos.pieceOn(moveFrom(m))) != type) continue;
+        if (fromCol >= 0 && colOf(moveFrom(m)) != fromCol) continue;
+        const bool isPromo = moveKind(m) == MoveKind::PROMOTION;
+        if (isPromo != (promo != PieceType::EMPTY) || (isPromo && movePromotion(m) != promo)) continue;
+        candidates.push_back(m);
+    }
+    if (candidates.size() > 1) {
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [&](EngineMove m) { return pos.isCapture(m) != capture; }),
+                         candidates.end());
+    }
+    return candidates.size() == 1 ? candidates[0] : NO_MOVE;
+}
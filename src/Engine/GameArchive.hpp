@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include "Position.hpp"
+
+// Reading the games GameRecorder saves in recent_games/, for the offline tools
+// (book_builder, puzzle_extractor).
+//
+// Files are grouped by variant subdirectory; files directly in recent_games/
+// count as "standard". A file is the move list ("1. e4 e5" per line) followed by
+// the result and a "Reason:" line. Chess960 games start with a "FEN: ..." line
+// holding the shuffled starting position. Post-game analyses (*_analysis.txt)
+// are not games and are skipped.
+
+struct ArchivedGame {
+    std::string startFen;               // from the FEN: line, empty if none
+    std::vector<std::string> moves;     // as recorded ("e4", "Nf3", "exd5", "e8=Q+", "O-O", ...)
+    int result = -1;                    // White's half points: 2 win, 1 draw, 0 loss; -1 unknown
+};
+
+// Game files under dir by variant
+std::map<std::string, std::vector<std::filesystem::path>> listArchive(const std::filesystem::path& dir);
+
+// False if the file cannot be read; a game without a result is still returned
+bool readArchivedGame(const std::filesystem::path& file, ArchivedGame& game);
+
+// Engine variant of a recorder variant name ("standard", "fischer", "diagonal")
+Variant archivedVariant(const std::string& variant);
+
+// Starting position of a game: its FEN line, otherwise the variant's standard setup
+// from GameLogic. False for Chess960 games saved without a FEN line.
+bool archivedStartPosition(const std::string& variant, const ArchivedGame& game, Position& pos);
+
+// Match one recorded move against the legal moves of pos. The recorder writes no
+// disambiguation, so NO_MOVE is returned for ambiguous moves as well as illegal ones.
+EngineMove parseRecordedMove(const Position& pos, std::string san);
@@ -0,0 +1,22 @@
+#include "Kpk.hpp"
+
+namespace Kpk {
+
+bool probe(Color strongSide, int strongKing, int pawn, int weakKing, Color sideToMove) {
+    // Mirror Black's pawn onto White's side of the board, then the pawn onto files a-d
+    if (strongSide == Color::BLACK) {
+        strongKing = flipRow(strongKing);
+        pawn = flipRow(pawn);
+        weakKing = flipRow(weakKing);
+        sideToMove = opposite(sideToMove);
+    }
+    if (colOf(pawn) > 3) {
+        strongKing ^= 7;
+        pawn ^= 7;
+        weakKing ^= 7;
+    }
+    const int i = index(sideToMove, strongKing, weakKing, pawn);
+    return (BITBASE[i >> 5] >> (i & 31)) & 1;
+}
+
+} // namespace Kpk
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include "Bitboard.hpp"
+
+// King + pawn vs king win/draw bitbase.
+//
+// Positions are normalised so that White has the pawn on files a-d; one bit
+// per (pawn square, side to move, white king, black king) tells whether
+// White wins. The 24 KB table is produced by retrograde analysis in
+// tools/kpk_generator at build time and compiled in as a constant.
+namespace Kpk {
+
+constexpr int PAWN_SQUARES = 24; // files a-d, rows 1-6 (ranks 7 down to 2)
+constexpr int SIZE = PAWN_SQUARES * 2 * 64 * 64;
+
+constexpr int index(Color sideToMove, int whiteKing, int blackKing, int pawn) {
+    return (((colOf(pawn) * 6 + rowOf(pawn) - 1) * 2 + static_cast<int>(sideToMove)) * 64 + whiteKing) * 64 + blackKing;
+}
+
+extern const std::uint32_t BITBASE[SIZE / 32];
+
+// True if the side with the pawn wins with best play
+bool probe(Color strongSide, int strongKing, int pawn, int weakKing, Color sideToMove);
+
+} // namespace Kpk
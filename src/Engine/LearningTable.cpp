@@ -0,0 +1,69 @@
+#include "LearningTable.hpp"
+#include "OpeningBook.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+bool LearningTable::open(const std::string& path, std::size_t entries) {
+    std::size_t buckets = 1;
+    while (buckets * 2 * LEARN_BUCKET_SIZE <= entries) buckets *= 2;
+    const std::size_t count = buckets * LEARN_BUCKET_SIZE;
+    const std::size_t size = sizeof(LearnFileHeader) + count * sizeof(LearnEntry);
+
+    // Reuse a matching file; anything else is replaced by an empty table
+    LearnFileHeader header{};
+    if (file_.open(path, true) && file_.size() >= sizeof(header)) {
+        std::memcpy(&header, file_.data(), sizeof(header));
+    }
+    const bool valid = header.magic == LEARN_MAGIC && header.version == LEARN_VERSION &&
+                       header.entries == count && file_.size() == size;
+    if (!valid) {
+        if (!file_.create(path, size)) return false;
+        header = LearnFileHeader{};
+        header.magic = LEARN_MAGIC;
+        header.version = LEARN_VERSION;
+        header.entries = count;
+        std::memcpy(file_.data(), &header, sizeof(header));
+    }
+    bucketMask_ = buckets - 1;
+    return true;
+}
+
+LearnEntry* LearningTable::bucket(std::uint64_t key) const {
+    auto* entries = reinterpret_cast<LearnEntry*>(const_cast<std::uint8_t*>(file_.data()) + sizeof(LearnFileHeader));
+    return entries + (key & bucketMask_) * LEARN_BUCKET_SIZE;
+}
+
+bool LearningTable::probe(const Position& pos, LearnEntry& out) const {
+    if (!isOpen()) return false;
+    const std::uint64_t key = polyglotKey(pos);
+    const LearnEntry* b = bucket(key);
+    for (int i = 0; i < LEARN_BUCKET_SIZE; ++i) {
+        if (b[i].key != key || b[i].depth == 0) continue;
+        if (!pos.isPseudoLegal(b[i].move) || !pos.isLegal(b[i].move)) return false;
+        out = b[i];
+        return true;
+    }
+    return false;
+}
+
+void LearningTable::store(const Position& pos, EngineMove move, int score, int depth) {
+    if (!isOpen() || move == NO_MOVE || depth <= 0) return;
+    const std::uint64_t key = polyglotKey(pos);
+    LearnEntry* b = bucket(key);
+
+    // Same position first, then an empty slot, then the shallowest result
+    LearnEntry* victim = &b[0];
+    for (int i = 0; i < LEARN_BUCKET_SIZE; ++i) {
+        if (b[i].key == key) {
+            if (b[i].depth > depth) return;
+            victim = &b[i];
+            break;
+        }
+        if (b[i].depth < victim->depth) victim = &b[i];
+    }
+    victim->key = key;
+    victim->move = move;
+    victim->score = static_cast<std::int16_t>(score);
+    victim->depth = static_cast<std::uint8_t>(std::min(depth, 255));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "MappedFile.hpp"
+#include "Position.hpp"
+
+// Deep search results for positions the bot has actually played, kept in a
+// memory-mapped file so they survive between sessions. Stores go straight to
+// the mapping and reach the disk whenever the OS writes the pages back (or at
+// flush()/close), so playing never waits for I/O.
+//
+// The file is a 64-byte header followed by buckets of LEARN_BUCKET_SIZE
+// 16-byte entries. Positions are keyed with polyglotKey(), which does not
+// depend on the engine's internal Zobrist constants. A bucket keeps the
+// deepest results; moves read back are checked for legality before use.
+
+struct LearnEntry {
+    std::uint64_t key = 0;
+    std::uint16_t move = NO_MOVE;
+    std::int16_t score = 0;
+    std::uint8_t depth = 0;
+    std::uint8_t reserved[3] = {};
+};
+
+static_assert(sizeof(LearnEntry) == 16, "learning table entries are 16 bytes on disk");
+
+constexpr std::uint32_t LEARN_MAGIC = 0x4E4C4843; // "CHLN"
+constexpr std::uint32_t LEARN_VERSION = 2;
+constexpr int LEARN_BUCKET_SIZE = 4;
+constexpr std::size_t LEARN_DEFAULT_ENTRIES = 1 << 18; // 4 MB
+
+struct LearnFileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t entries;
+    std::uint8_t reserved[48];
+};
+
+static_assert(sizeof(LearnFileHeader) == 64, "learning table header is 64 bytes on disk");
+
+class LearningTable {
+public:
+    // Map the table at path, creating an empty one when the file is missing or was
+    // written by another version. entries is rounded down to a power of two.
+    bool open(const std::string& path, std::size_t entries = LEARN_DEFAULT_ENTRIES);
+    void close() { file_.close(); }
+    bool isOpen() const { return file_.isOpen(); }
+
+    // Stored result for the position, if any; move is a legal move of pos
+    bool probe(const Position& pos, LearnEntry& out) const;
+
+    // Keep a search result unless the table already knows the position deeper
+    void store(const Position& pos, EngineMove move, int score, int depth);
+
+    // Force dirty pages to disk (normally left to the OS)
+    void flush() { file_.flush(); }
+
+private:
+    LearnEntry* bucket(std::uint64_t key) const;
+
+    MappedFile file_;
+    std::size_t bucketMask_ = 0;
+};
@@ -0,0 +1,94 @@
+#include "LiveAnalyzer.hpp"
+
+LiveAnalyzer::LiveAnalyzer(std::chrono::milliseconds interval) : interval_(interval) {
+    thread_ = std::thread([this] { run(); });
+}
+
+LiveAnalyzer::~LiveAnalyzer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+        ++generation_;
+    }
+    cv_.notify_all();
+    search_.stop();
+    thread_.join();
+}
+
+void LiveAnalyzer::setPosition(const Position& pos) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = pos;
+        hasPending_ = true;
+        ++generation_;
+        fresh_ = false;
+    }
+    cv_.notify_all();
+    search_.stop();
+}
+
+void LiveAnalyzer::pause() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hasPending_ = false;
+        ++generation_;
+        fresh_ = false;
+    }
+    search_.stop();
+}
+
+bool LiveAnalyzer::poll(LiveEvaluation& out) {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !fresh_ || latestGeneration_ != generation_) return false;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!firstOfPosition_ && now - lastDelivered_ < interval_) return false;
+    out = latest_;
+    fresh_ = false;
+    firstOfPosition_ = false;
+    lastDelivered_ = now;
+    return true;
+}
+
+void LiveAnalyzer::run() {
+    for (;;) {
+        Position pos;
+        std::uint64_t generation = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return quit_ || hasPending_; });
+            if (quit_) return;
+            pos = pending_;
+            hasPending_ = false;
+            generation = generation_;
+            firstOfPosition_ = true;
+        }
+
+        const bool white = pos.sideToMove() == Color::WHITE;
+        auto publish = [&](const SearchResult& r) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (generation != generation_) return;
+            latest_ = LiveEvaluation{pos.key(), r.bestMove, white ? r.score : -r.score, r.depth};
+            latestGeneration_ = generation;
+            fresh_ = true;
+        };
+
+        // A stop() that came before think() started is cleared by it, so a stale
+        // search also stops itself at its next completed iteration
+        search_.setIterationCallback([&](const SearchResult& r) {
+            if (generation != generation_) {
+                search_.stop();
+                return;
+            }
+            publish(r);
+        });
+
+        MoveList legal;
+        pos.legalMoves(legal);
+        if (legal.size > 0 && generation == generation_) {
+            const SearchResult r = search_.think(pos, SearchLimits{});
+            if (r.bestMove != NO_MOVE) publish(r);
+        }
+        search_.setIterationCallback(nullptr);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "Position.hpp"
+#include "Search.hpp"
+
+// Continuous analysis of the position on the board for the evaluation bar and
+// the best-move arrow.
+//
+// A worker thread searches the current position without limits. Nothing the
+// GUI calls ever waits for it: setPosition() only hands over the new position
+// and asks the running search to stop, and poll() gives up at once if the
+// worker happens to hold the lock. Results of a stale position are dropped,
+// and the GUI gets at most one update per interval (the first result of a new
+// position comes through immediately), so the bar does not flicker between
+// iterations.
+
+struct LiveEvaluation {
+    std::uint64_t key = 0;          // Position::key() of the analysed position
+    EngineMove bestMove = NO_MOVE;
+    int score = 0;                  // White's point of view
+    int depth = 0;
+};
+
+class LiveAnalyzer {
+public:
+    explicit LiveAnalyzer(std::chrono::milliseconds interval = std::chrono::milliseconds(200));
+    ~LiveAnalyzer();
+
+    LiveAnalyzer(const LiveAnalyzer&) = delete;
+    LiveAnalyzer& operator=(const LiveAnalyzer&) = delete;
+
+    // Start analysing pos, abandoning the previous position
+    void setPosition(const Position& pos);
+
+    // Stop analysing until the next setPosition()
+    void pause();
+
+    // Newest evaluation of the current position, if there is one not yet returned
+    // and the update interval has passed
+    bool poll(LiveEvaluation& out);
+
+private:
+    void run();
+
+    Search search_;
+    std::chrono::milliseconds interval_;
+    std::chrono::steady_clock::time_point lastDelivered_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    Position pending_;
+    bool hasPending_ = false;
+    bool quit_ = false;
+    std::atomic<std::uint64_t> generation_{0};  // bumped by every setPosition() and pause()
+
+    // Guarded by mutex_
+    LiveEvaluation latest_;
+    std::uint64_t latestGeneration_ = 0;
+    bool fresh_ = false;
+    bool firstOfPosition_ = false;
+};
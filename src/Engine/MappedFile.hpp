@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only or read-write memory mapping of a whole file (POSIX mmap or
+// Win32 file mapping). Used for opening books and other large engine tables
+// that should be paged in by the OS instead of read up front.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map an existing file. Returns false if it cannot be opened or is empty.
+    bool open(const std::string& path, bool writable = false);
+
+    // Create (or truncate) a file of the given size and map it writable
+    bool create(const std::string& path, std::size_t size);
+
+    void close();
+
+    // Write dirty pages of a writable mapping back to disk
+    void flush();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const std::uint8_t* data() const { return data_; }
+    std::uint8_t* data() { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    bool mapHandle(bool writable);
+
+    std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
@@ -0,0 +1,397 @@
+#include "MctsSearch.hpp"
+#include "Evaluate.hpp"
+#include "MovePicker.hpp"
+#include "PawnTable.hpp"
+#include "Psqt.hpp"
+#include "See.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr double VALUE_SCALE = 65536.0;   // fixed point of MctsNode::valueSum
+constexpr float PUCT_C = 1.5f;
+constexpr float FPU_REDUCTION = 0.2f;      // unvisited children start this much below their parent
+constexpr int QS_MAX_DEPTH = 8;
+
+// Win probability for the side to move from a centipawn score, and back
+float winProbability(int cp) {
+    return static_cast<float>(1.0 / (1.0 + std::pow(10.0, -cp / 200.0)));
+}
+
+int centipawns(double p) {
+    p = std::clamp(p, 0.001, 0.999);
+    return static_cast<int>(std::lround(-200.0 * std::log10(1.0 / p - 1.0)));
+}
+
+double meanValue(const MctsNode& n) {
+    const std::uint32_t v = n.visits.load(std::memory_order_relaxed);
+    return v ? n.valueSum.load(std::memory_order_relaxed) / VALUE_SCALE / v : 0.5;
+}
+
+// Unnormalised log-prior of a move: winning exchanges, promotions and checks first,
+// then quiet moves by how much they improve the piece's square
+float priorLogit(Position& pos, EngineMove m) {
+    float logit = 0.0f;
+    if (moveKind(m) == MoveKind::PROMOTION) logit += movePromotion(m) == PieceType::QUEEN ? 2.5f : -1.0f;
+    if (pos.isCapture(m)) {
+        const int see = staticExchange(pos, m);
+        logit += see >= 0 ? 1.5f + see / 400.0f : -0.5f + see / 400.0f;
+    } else if (moveKind(m) == MoveKind::CASTLING) {
+        logit += 0.5f;
+    } else {
+        const int pc = pos.pieceOn(moveFrom(m));
+        const int gain = Psqt::PIECE_SQUARE[pc][moveTo(m)].mg - Psqt::PIECE_SQUARE[pc][moveFrom(m)].mg;
+        logit += (pos.sideToMove() == Color::WHITE ? gain : -gain) / 50.0f;
+    }
+    if (pos.givesCheck(m)) logit += 0.8f;
+    return logit;
+}
+
+} // namespace
+
+struct MctsSearch::Worker {
+    Position pos;
+    PawnTable pawns{4096};
+    HistoryTables history;   // only orders evasions in the quiescence search
+    std::vector<std::uint32_t> path;
+
+    Worker() { history.clear(); }
+};
+
+void MctsArena::reserve(std::size_t capacity) {
+    if (capacity_ == capacity) return;
+    nodes_ = std::make_unique<MctsNode[]>(capacity);
+    capacity_ = capacity;
+    used_ = 0;
+}
+
+std::uint32_t MctsArena::allocate(std::uint32_t count) {
+    std::size_t start = used_.load(std::memory_order_relaxed);
+    do {
+        if (start + count > capacity_) return NONE;
+    } while (!used_.compare_exchange_weak(start, start + count, std::memory_order_relaxed));
+
+    // Reset recycled nodes before anyone can reach them
+    for (std::uint32_t i = 0; i < count; ++i) {
+        MctsNode& n = nodes_[start + i];
+        n.move = NO_MOVE;
+        n.childCount = 0;
+        n.firstChild = 0;
+        n.prior = n.terminalValue = 0.0f;
+        n.state.store(MCTS_LEAF, std::memory_order_relaxed);
+        n.visits.store(0, std::memory_order_relaxed);
+        n.virtualLoss.store(0, std::memory_order_relaxed);
+        n.valueSum.store(0, std::memory_order_relaxed);
+    }
+    return static_cast<std::uint32_t>(start);
+}
+
+MctsSearch::MctsSearch(int threads, std::size_t arenaNodes) : arenaNodes_(arenaNodes), threads_(std::max(threads, 1)) {}
+
+void MctsSearch::clear() {
+    arenas_[0].reset();
+    arenas_[1].reset();
+    root_ = MctsArena::NONE;
+}
+
+SearchResult MctsSearch::think(const Position& root, const SearchLimits& limits) {
+    limits_ = limits;
+    time_.init(limits, root.gamePly());
+    stopRequested_ = false;
+    finished_ = false;
+    playouts_ = 0;
+    selDepth_ = 0;
+
+    SearchResult result;
+    rootMoves_ = rootMoves(root, limits);
+    if (rootMoves_.size == 0) return result;
+    result.bestMove = rootMoves_.moves[0];
+
+    // The arenas are only allocated once the engine is actually used
+    arenas_[0].reserve(arenaNodes_);
+    arenas_[1].reserve(arenaNodes_);
+
+    // Keep what earlier searches learned about this position, if it is in the tree. A root
+    // limited to searchmoves lacks children, so such searches start and leave a fresh tree.
+    const bool restricted = !limits.searchMoves.empty();
+    const std::uint32_t reused =
+        root_ == MctsArena::NONE || restricted || rootRestricted_ ? MctsArena::NONE : findRoot(root);
+    rootRestricted_ = restricted;
+    if (reused != MctsArena::NONE) {
+        rebase(reused);
+    } else {
+        arenas_[active_].reset();
+        root_ = arenas_[active_].allocate(1);
+    }
+    rootPos_ = root;
+
+    std::vector<Worker> workers(threads_);
+    for (Worker& w : workers) w.pos = root;
+    if (arenas_[active_][root_].state.load() == MCTS_LEAF) {
+        arenas_[active_][root_].state = MCTS_EXPANDING;
+        expand(root_, workers[0]);
+    }
+
+    // A forced move needs no thought
+    if (rootMoves_.size > 1) {
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threads_; ++i) threads.emplace_back([this, &workers, i] { playouts(workers[i]); });
+        playouts(workers[0]);
+        for (auto& t : threads) t.join();
+    }
+
+    // Most visited child, then down the tree for the principal variation
+    const MctsArena& arena = arenas_[active_];
+    std::uint32_t idx = root_;
+    while (arena[idx].state.load() == MCTS_EXPANDED && result.pv.size() < MAX_PLY) {
+        const MctsNode& node = arena[idx];
+        std::uint32_t best = MctsArena::NONE;
+        for (std::uint32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+            if (best == MctsArena::NONE || arena[c].visits > arena[best].visits) best = c;
+        }
+        if (arena[best].visits == 0) break;
+        result.pv.push_back(arena[best].move);
+        idx = best;
+    }
+    if (!result.pv.empty()) {
+        result.bestMove = result.pv[0];
+        const MctsNode& node = arena[root_];
+        for (std::uint32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+            if (arena[c].move == result.bestMove) result.score = centipawns(meanValue(arena[c]));
+        }
+    }
+    result.depth = static_cast<int>(result.pv.size());
+    result.selDepth = selDepth_;
+    result.nodes = playouts_;
+    result.timeMs = time_.elapsedMs();
+    return result;
+}
+
+bool MctsSearch::limitReached() {
+    if (stopRequested_) return true;
+    if (limits_.nodes && playouts_ >= limits_.nodes) return true;
+    if (time_.isTimed() && time_.elapsedMs() >= time_.softLimitMs()) return true;
+    return false;
+}
+
+void MctsSearch::playouts(Worker& w) {
+    MctsArena& arena = arenas_[active_];
+    while (!finished_) {
+        // Descend with virtual losses on the way
+        w.path.clear();
+        std::uint32_t idx = root_;
+        float value; // for the side to move at the end of the path
+        while (true) {
+            w.path.push_back(idx);
+            MctsNode& node = arena[idx];
+            std::uint8_t state = node.state.load(std::memory_order_acquire);
+            if (state == MCTS_TERMINAL) {
+                value = node.terminalValue;
+                break;
+            }
+            if (state == MCTS_LEAF && node.state.compare_exchange_strong(state, MCTS_EXPANDING)) {
+                value = expand(idx, w);
+                break;
+            }
+            if (state != MCTS_EXPANDED) {
+                // Another thread is expanding it
+                value = evaluateLeaf(w);
+                break;
+            }
+            idx = select(idx);
+            arena[idx].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+            w.pos.doMove(arena[idx].move);
+        }
+
+        const int depth = static_cast<int>(w.path.size()) - 1;
+        for (int seen = selDepth_.load(); depth > seen && !selDepth_.compare_exchange_weak(seen, depth);) {
+        }
+
+        // Back up: each node holds the value for the side that moved into it
+        for (std::size_t i = w.path.size(); i-- > 0;) {
+            MctsNode& node = arena[w.path[i]];
+            value = 1.0f - value;
+            node.valueSum.fetch_add(static_cast<std::uint64_t>(value * VALUE_SCALE + 0.5), std::memory_order_relaxed);
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+            if (i > 0) {
+                node.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+                w.pos.undoMove(node.move);
+            }
+        }
+
+        const std::uint64_t done = ++playouts_;
+        if (((done & 63) == 0 || limits_.nodes) && limitReached()) finished_ = true;
+    }
+}
+
+std::uint32_t MctsSearch::select(std::uint32_t idx) const {
+    const MctsArena& arena = arenas_[active_];
+    const MctsNode& node = arena[idx];
+    const std::uint32_t parentVisits = node.visits.load(std::memory_order_relaxed) +
+                                       node.virtualLoss.load(std::memory_order_relaxed);
+    const float sqrtN = std::sqrt(static_cast<float>(std::max<std::uint32_t>(parentVisits, 1)));
+    // The parent's value from the view of its side to move
+    const float fpu = static_cast<float>(1.0 - meanValue(node)) - FPU_REDUCTION;
+
+    std::uint32_t best = node.firstChild;
+    float bestScore = -1e9f;
+    for (std::uint32_t c = node.firstChild; c < node.firstChild + node.childCount; ++c) {
+        const MctsNode& child = arena[c];
+        const std::uint32_t n = child.visits.load(std::memory_order_relaxed);
+        const std::uint32_t vl = child.virtualLoss.load(std::memory_order_relaxed);
+        // Virtual losses count as visits that scored nothing
+        float q = fpu;
+        if (child.state.load(std::memory_order_acquire) == MCTS_TERMINAL && n == 0) q = 1.0f - child.terminalValue;
+        else if (n + vl > 0) q = static_cast<float>(child.valueSum.load(std::memory_order_relaxed) / VALUE_SCALE / (n + vl));
+        const float score = q + PUCT_C * child.prior * sqrtN / (1.0f + n + vl);
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+// Create the children of a node this thread has claimed (state EXPANDING) and
+// return the value of its position for the side to move
+float MctsSearch::expand(std::uint32_t idx, Worker& w) {
+    MctsArena& arena = arenas_[active_];
+    MctsNode& node = arena[idx];
+    Position& pos = w.pos;
+
+    const bool isRoot = idx == root_;
+    MoveList legal;
+    if (isRoot) legal = rootMoves_;
+    else pos.legalMoves(legal);
+    if (legal.size == 0 || (!isRoot && pos.isDraw())) {
+        node.terminalValue = legal.size == 0 && pos.inCheck() ? 0.0f : 0.5f;
+        node.state.store(MCTS_TERMINAL, std::memory_order_release);
+        return node.terminalValue;
+    }
+
+    const std::uint32_t first = arena.allocate(static_cast<std::uint32_t>(legal.size));
+    if (first == MctsArena::NONE) {
+        // Arena full: the tree stops growing, playouts still refine it
+        node.state.store(MCTS_LEAF, std::memory_order_release);
+        return evaluateLeaf(w);
+    }
+
+    float logits[256];
+    float maxLogit = -1e9f;
+    for (int i = 0; i < legal.size; ++i) {
+        logits[i] = priorLogit(pos, legal.moves[i]);
+        maxLogit = std::max(maxLogit, logits[i]);
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < legal.size; ++i) sum += logits[i] = std::exp(logits[i] - maxLogit);
+    for (int i = 0; i < legal.size; ++i) {
+        arena[first + i].move = legal.moves[i];
+        arena[first + i].prior = logits[i] / sum;
+    }
+
+    const float value = evaluateLeaf(w);
+    node.firstChild = first;
+    node.childCount = static_cast<std::uint16_t>(legal.size);
+    node.state.store(MCTS_EXPANDED, std::memory_order_release);
+    return value;
+}
+
+float MctsSearch::evaluateLeaf(Worker& w) {
+    return winProbability(quiescence(w, -VALUE_INFINITE, VALUE_INFINITE, 0));
+}
+
+// Captures-only search so that leaves are not valued in the middle of an exchange
+int MctsSearch::quiescence(Worker& w, int alpha, int beta, int depth) {
+    Position& pos = w.pos;
+    const bool inCheck = pos.inCheck();
+    int bestScore = -VALUE_MATE;
+    if (!inCheck) {
+        bestScore = evaluate(pos, w.pawns);
+        if (bestScore >= beta || depth >= QS_MAX_DEPTH) return bestScore;
+        alpha = std::max(alpha, bestScore);
+    }
+
+    MovePicker picker(pos, inCheck, w.history);
+    EngineMove m;
+    while ((m = picker.next()) != NO_MOVE) {
+        if (!pos.isLegal(m)) continue;
+        if (!inCheck && moveKind(m) != MoveKind::PROMOTION && staticExchange(pos, m) < 0) continue;
+        pos.doMove(m);
+        const int score = -quiescence(w, -beta, -alpha, depth + 1);
+        pos.undoMove(m);
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) alpha = score;
+            if (alpha >= beta) break;
+        }
+    }
+    return bestScore;
+}
+
+// Node of the current tree whose position is pos: the root itself, or a position
+// up to two plies below it (our last move and the opponent's reply)
+std::uint32_t MctsSearch::findRoot(const Position& pos) const {
+    const MctsArena& arena = arenas_[active_];
+    if (rootPos_.key() == pos.key()) return root_;
+    Position p = rootPos_;
+    const MctsNode& root = arena[root_];
+    if (root.state.load() != MCTS_EXPANDED) return MctsArena::NONE;
+    for (std::uint32_t c = root.firstChild; c < root.firstChild + root.childCount; ++c) {
+        p.doMove(arena[c].move);
+        if (p.key() == pos.key()) return c;
+        const MctsNode& child = arena[c];
+        if (child.state.load() == MCTS_EXPANDED) {
+            for (std::uint32_t g = child.firstChild; g < child.firstChild + child.childCount; ++g) {
+                p.doMove(arena[g].move);
+                const bool found = p.key() == pos.key();
+                p.undoMove(arena[g].move);
+                if (found) return g;
+            }
+        }
+        p.undoMove(arena[c].move);
+    }
+    return MctsArena::NONE;
+}
+
+// Copy the subtree under idx into the other arena, breadth first so that every
+// block of siblings stays contiguous, and make it the tree
+void MctsSearch::rebase(std::uint32_t idx) {
+    const MctsArena& from = arenas_[active_];
+    MctsArena& to = arenas_[active_ ^ 1];
+    to.reset();
+
+    auto copy = [](const MctsNode& src, MctsNode& dst) {
+        dst.move = src.move;
+        dst.prior = src.prior;
+        dst.terminalValue = src.terminalValue;
+        dst.state.store(src.state.load() == MCTS_TERMINAL ? MCTS_TERMINAL : MCTS_LEAF);
+        dst.visits.store(src.visits.load());
+        dst.valueSum.store(src.valueSum.load());
+    };
+
+    const std::uint32_t newRoot = to.allocate(1);
+    copy(from[idx], to[newRoot]);
+    // A node can be terminal only as a repetition seen from the old root; the new
+    // root has legal moves to search, so it is expanded again if it was
+    if (to[newRoot].state.load() == MCTS_TERMINAL) to[newRoot].state.store(MCTS_LEAF);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> queue{{idx, newRoot}}; // (old, new)
+    for (std::size_t q = 0; q < queue.size(); ++q) {
+        const MctsNode& src = from[queue[q].first];
+        MctsNode& dst = to[queue[q].second];
+        if (src.state.load() != MCTS_EXPANDED) continue;
+        const std::uint32_t block = to.allocate(src.childCount);
+        for (std::uint32_t i = 0; i < src.childCount; ++i) {
+            copy(from[src.firstChild + i], to[block + i]);
+            queue.emplace_back(src.firstChild + i, block + i);
+        }
+        dst.firstChild = block;
+        dst.childCount = src.childCount;
+        dst.state.store(MCTS_EXPANDED);
+    }
+    active_ ^= 1;
+    root_ = newRoot;
+}
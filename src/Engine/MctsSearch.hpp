@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "Position.hpp"
+#include "Search.hpp"
+#include "TimeManager.hpp"
+
+// Monte Carlo tree search over a Position, an alternative to the alpha-beta
+// Search with a different playing style.
+//
+// Every playout walks down the tree choosing children by PUCT (value plus a
+// prior-weighted exploration bonus), expands the leaf it reaches and backs up
+// a win probability taken from a short quiescence search. Priors come from
+// cheap move features (exchange value, promotions, checks, piece-square gain).
+//
+// Playouts run on several threads over one shared tree. A thread descending
+// through a node adds a virtual loss to it until its result is backed up, so
+// the other threads spread out over different lines instead of queueing on
+// the same one. Nodes live in a pre-allocated arena; children of a node are
+// one contiguous block. Between moves the subtree of the new position is kept
+// by copying it into a second arena, which also drops the rest of the tree.
+
+struct MctsNode {
+    EngineMove move = NO_MOVE;              // move leading to this node
+    std::uint16_t childCount = 0;
+    std::uint32_t firstChild = 0;           // index in the arena, valid once expanded
+    float prior = 0.0f;
+    float terminalValue = 0.0f;
+    std::atomic<std::uint8_t> state{0};     // MctsNodeState
+    std::atomic<std::uint32_t> visits{0};
+    std::atomic<std::uint32_t> virtualLoss{0};
+    std::atomic<std::uint64_t> valueSum{0}; // fixed point, from the view of the side that played move
+};
+
+enum MctsNodeState : std::uint8_t { MCTS_LEAF, MCTS_EXPANDING, MCTS_EXPANDED, MCTS_TERMINAL };
+
+// Bump allocator of nodes; allocation is lock-free and never touches the heap
+class MctsArena {
+public:
+    static constexpr std::uint32_t NONE = 0xFFFFFFFFu;
+
+    void reserve(std::size_t capacity);
+    void reset() { used_ = 0; }
+
+    // Index of count consecutive fresh nodes, or NONE when the arena is full
+    std::uint32_t allocate(std::uint32_t count);
+
+    MctsNode& operator[](std::uint32_t i) { return nodes_[i]; }
+    const MctsNode& operator[](std::uint32_t i) const { return nodes_[i]; }
+    std::size_t used() const { return used_; }
+    std::size_t capacity() const { return capacity_; }
+
+private:
+    std::unique_ptr<MctsNode[]> nodes_;
+    std::size_t capacity_ = 0;
+    std::atomic<std::size_t> used_{0};
+};
+
+class MctsSearch {
+public:
+    // Per arena. An arena takes DEFAULT_NODES * sizeof(MctsNode) bytes (40 MB on x86-64)
+    // and two are reserved on the first think(), so about 80 MB per engine.
+    static constexpr std::size_t DEFAULT_NODES = 1 << 20;
+
+    explicit MctsSearch(int threads = 1, std::size_t arenaNodes = DEFAULT_NODES);
+
+    void setThreads(int threads) { threads_ = threads < 1 ? 1 : threads; }
+
+    // Run playouts until the limits (clock, moveTimeMs, nodes = playouts) or stop().
+    // The best move is the most visited one; score is its win rate converted back to
+    // centipawns, pv follows the most visited children and depth is its length.
+    // nodes counts playouts and selDepth the longest path walked by one.
+    SearchResult think(const Position& root, const SearchLimits& limits);
+
+    void stop() { stopRequested_ = true; }
+
+    // Drop the tree (new game)
+    void clear();
+
+private:
+    struct Worker;
+
+    void playouts(Worker& worker);
+    float expand(std::uint32_t idx, Worker& worker);
+    float evaluateLeaf(Worker& worker);
+    int quiescence(Worker& worker, int alpha, int beta, int depth);
+    std::uint32_t select(std::uint32_t idx) const;
+    std::uint32_t findRoot(const Position& pos) const;
+    void rebase(std::uint32_t idx);
+    bool limitReached();
+
+    MctsArena arenas_[2];
+    int active_ = 0;
+    std::uint32_t root_ = MctsArena::NONE;
+    Position rootPos_;
+    MoveList rootMoves_;                    // children the root is expanded with
+    bool rootRestricted_ = false;           // the tree's root was limited to searchmoves
+    std::size_t arenaNodes_;
+    int threads_;
+
+    SearchLimits limits_;
+    TimeManager time_;
+    std::atomic<bool> stopRequested_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<std::uint64_t> playouts_{0};
+    std::atomic<int> selDepth_{0};          // longest path walked by a playout
+};
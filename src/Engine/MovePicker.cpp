@@ -0,0 +1,209 @@
+#include "MovePicker.hpp"
+#include "Evaluate.hpp"
+#include "See.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+void HistoryTables::clear() {
+    std::memset(butterfly, 0, sizeof(butterfly));
+    for (auto& row : counter)
+        for (EngineMove& m : row) m = NO_MOVE;
+}
+
+void HistoryTables::age() {
+    for (auto& side : butterfly)
+        for (auto& from : side)
+            for (int& h : from) h /= 2;
+}
+
+void HistoryTables::updateQuiet(Color side, EngineMove m, int bonus) {
+    // Gravity keeps entries inside +-16384 and lets recent results dominate
+    int& h = butterfly[static_cast<int>(side)][moveFrom(m)][moveTo(m)];
+    h += bonus - h * std::abs(bonus) / 16384;
+}
+
+MovePicker::MovePicker(const Position& pos, EngineMove ttMove, const EngineMove* killers,
+                       EngineMove counterMove, const HistoryTables& history)
+    : pos_(pos), history_(history), phase_(Phase::TT) {
+    ttMove_ = pos.isPseudoLegal(ttMove) ? ttMove : NO_MOVE;
+    for (int i = 0; i < 2; ++i) {
+        if (killers[i] != ttMove_ && isQuietRefutation(killers[i])) killers_[i] = killers[i];
+    }
+    if (counterMove != ttMove_ && counterMove != killers_[0] && counterMove != killers_[1] &&
+        isQuietRefutation(counterMove)) {
+        counter_ = counterMove;
+    }
+    if (ttMove_ == NO_MOVE) phase_ = Phase::GEN_CAPTURES;
+}
+
+MovePicker::MovePicker(const Position& pos, bool inCheck, const HistoryTables& history)
+    : pos_(pos), history_(history), phase_(inCheck ? Phase::QS_GEN_EVASIONS : Phase::QS_GEN_CAPTURES) {}
+
+bool MovePicker::isQuietRefutation(EngineMove m) const {
+    return m != NO_MOVE && pos_.isPseudoLegal(m) && !pos_.isCapture(m) && moveKind(m) != MoveKind::PROMOTION;
+}
+
+bool MovePicker::isSpecial(EngineMove m) const {
+    return m == ttMove_ || m == killers_[0] || m == killers_[1] || m == counter_;
+}
+
+void MovePicker::scoreCaptures(int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        EngineMove m = list_.moves[i];
+        if (moveKind(m) == MoveKind::PROMOTION && !pos_.isCapture(m)) {
+            scores_[i] = pieceValue(movePromotion(m));
+            continue;
+        }
+        int victim = moveKind(m) == MoveKind::EN_PASSANT ? pieceValue(PieceType::PAWN)
+                                                          : pieceValue(pieceType(pos_.pieceOn(moveTo(m))));
+        int attacker = pieceValue(pieceType(pos_.pieceOn(moveFrom(m))));
+        scores_[i] = victim * 10 - attacker / 10;
+        if (moveKind(m) == MoveKind::PROMOTION) scores_[i] += pieceValue(movePromotion(m));
+    }
+}
+
+void MovePicker::scoreQuiets(int begin, int end) {
+    const int side = static_cast<int>(pos_.sideToMove());
+    for (int i = begin; i < end; ++i) {
+        EngineMove m = list_.moves[i];
+        scores_[i] = history_.butterfly[side][moveFrom(m)][moveTo(m)];
+    }
+}
+
+EngineMove MovePicker::pickBest() {
+    int best = cur_;
+    for (int i = cur_ + 1; i < end_; ++i) {
+        if (scores_[i] > scores_[best]) best = i;
+    }
+    std::swap(list_.moves[best], list_.moves[cur_]);
+    std::swap(scores_[best], scores_[cur_]);
+    return list_.moves[cur_++];
+}
+
+EngineMove MovePicker::next() {
+    while (true) {
+        switch (phase_) {
+            case Phase::TT:
+                phase_ = Phase::GEN_CAPTURES;
+                lastStage_ = PickStage::TT_MOVE;
+                return ttMove_;
+
+            case Phase::GEN_CAPTURES:
+                list_.size = 0;
+                pos_.generate(GenType::TACTICAL, list_);
+                cur_ = 0;
+                end_ = list_.size;
+                scoreCaptures(0, end_);
+                phase_ = Phase::GOOD_CAPTURES;
+                break;
+
+            case Phase::GOOD_CAPTURES:
+                while (cur_ < end_) {
+                    EngineMove m = pickBest();
+                    if (m == ttMove_) continue;
+                    // Losing exchanges wait until after the quiet moves
+                    if (moveKind(m) != MoveKind::PROMOTION && staticExchange(pos_, m) < 0) {
+                        bad_[badCount_++] = m;
+                        continue;
+                    }
+                    lastStage_ = PickStage::GOOD_CAPTURES;
+                    return m;
+                }
+                phase_ = Phase::KILLER_1;
+                break;
+
+            case Phase::KILLER_1:
+                phase_ = Phase::KILLER_2;
+                if (killers_[0] != NO_MOVE) {
+                    lastStage_ = PickStage::KILLERS;
+                    return killers_[0];
+                }
+                break;
+
+            case Phase::KILLER_2:
+                phase_ = Phase::COUNTER;
+                if (killers_[1] != NO_MOVE && killers_[1] != killers_[0]) {
+                    lastStage_ = PickStage::KILLERS;
+                    return killers_[1];
+                }
+                break;
+
+            case Phase::COUNTER:
+                phase_ = Phase::GEN_QUIETS;
+                if (counter_ != NO_MOVE) {
+                    lastStage_ = PickStage::COUNTER_MOVE;
+                    return counter_;
+                }
+                break;
+
+            case Phase::GEN_QUIETS:
+                list_.size = 0;
+                pos_.generate(GenType::QUIET, list_);
+                cur_ = 0;
+                end_ = list_.size;
+                scoreQuiets(0, end_);
+                phase_ = Phase::QUIETS;
+                break;
+
+            case Phase::QUIETS:
+                while (cur_ < end_) {
+                    EngineMove m = pickBest();
+                    if (isSpecial(m)) continue;
+                    lastStage_ = PickStage::QUIETS;
+                    return m;
+                }
+                phase_ = Phase::BAD_CAPTURES;
+                break;
+
+            case Phase::BAD_CAPTURES:
+                if (badCur_ < badCount_) {
+                    lastStage_ = PickStage::BAD_CAPTURES;
+                    return bad_[badCur_++];
+                }
+                phase_ = Phase::END;
+                break;
+
+            case Phase::QS_GEN_CAPTURES:
+                pos_.generate(GenType::TACTICAL, list_);
+                cur_ = 0;
+                end_ = list_.size;
+                scoreCaptures(0, end_);
+                phase_ = Phase::QS_CAPTURES;
+                break;
+
+            case Phase::QS_CAPTURES:
+                if (cur_ < end_) {
+                    lastStage_ = PickStage::GOOD_CAPTURES;
+                    return pickBest();
+                }
+                phase_ = Phase::END;
+                break;
+
+            case Phase::QS_GEN_EVASIONS: {
+                pos_.generate(GenType::TACTICAL, list_);
+                int tactical = list_.size;
+                scoreCaptures(0, tactical);
+                for (int i = 0; i < tactical; ++i) scores_[i] += 1 << 20;
+                pos_.generate(GenType::QUIET, list_);
+                scoreQuiets(tactical, list_.size);
+                cur_ = 0;
+                end_ = list_.size;
+                phase_ = Phase::QS_EVASIONS;
+                break;
+            }
+
+            case Phase::QS_EVASIONS:
+                if (cur_ < end_) {
+                    lastStage_ = PickStage::EVASIONS;
+                    return pickBest();
+                }
+                phase_ = Phase::END;
+                break;
+
+            case Phase::END:
+                lastStage_ = PickStage::DONE;
+                return NO_MOVE;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include "Position.hpp"
+
+// Quiet-move statistics learned during search and reused across iterations
+struct HistoryTables {
+    int butterfly[2][64][64];     // [side][from][to], rewards quiet moves that caused cutoffs
+    EngineMove counter[12][64];   // [piece][to] of the previous move -> quiet reply that refuted it
+
+    void clear();
+    // Halve the history between searches so old games fade out
+    void age();
+    void updateQuiet(Color side, EngineMove m, int bonus);
+};
+
+// Order in which the main-search picker hands out moves
+enum class PickStage {
+    TT_MOVE,
+    GOOD_CAPTURES,
+    KILLERS,
+    COUNTER_MOVE,
+    QUIETS,
+    BAD_CAPTURES,
+    EVASIONS,   // quiescence search while in check
+    DONE
+};
+
+constexpr int PICK_STAGE_COUNT = static_cast<int>(PickStage::DONE) + 1;
+
+// Staged move generator. Returns pseudo-legal moves one at a time (caller
+// checks legality) so a cutoff by the hash move or a capture never pays for
+// generating and scoring the quiet moves.
+class MovePicker {
+public:
+    // Main search: hash move, SEE-winning captures (MVV-LVA), killers, counter move,
+    // quiets by history, then SEE-losing captures
+    MovePicker(const Position& pos, EngineMove ttMove, const EngineMove* killers,
+               EngineMove counterMove, const HistoryTables& history);
+
+    // Quiescence search: captures and promotions by MVV-LVA, or every evasion when in check
+    MovePicker(const Position& pos, bool inCheck, const HistoryTables& history);
+
+    EngineMove next();
+
+    // Stage that produced the move last returned by next()
+    PickStage stage() const { return lastStage_; }
+
+private:
+    enum class Phase {
+        TT, GEN_CAPTURES, GOOD_CAPTURES, KILLER_1, KILLER_2, COUNTER, GEN_QUIETS, QUIETS, BAD_CAPTURES,
+        QS_GEN_CAPTURES, QS_CAPTURES, QS_GEN_EVASIONS, QS_EVASIONS, END
+    };
+
+    void scoreCaptures(int begin, int end);
+    void scoreQuiets(int begin, int end);
+    // Move the best-scored remaining move to the front of [cur_, end_) and return it
+    EngineMove pickBest();
+    bool isSpecial(EngineMove m) const;
+    bool isQuietRefutation(EngineMove m) const;
+
+    const Position& pos_;
+    const HistoryTables& history_;
+    EngineMove ttMove_ = NO_MOVE;
+    EngineMove killers_[2] = {NO_MOVE, NO_MOVE};
+    EngineMove counter_ = NO_MOVE;
+
+    Phase phase_;
+    PickStage lastStage_ = PickStage::TT_MOVE;
+
+    MoveList list_;
+    int scores_[256];
+    int cur_ = 0;
+    int end_ = 0;
+    EngineMove bad_[256];
+    int badCount_ = 0;
+    int badCur_ = 0;
+};
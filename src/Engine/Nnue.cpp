@@ -0,0 +1,178 @@
+#include "Nnue.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Nnue {
+
+namespace {
+
+std::unique_ptr<Network> activeNet;
+
+// Weight files are little-endian; every supported target is as well, so the
+// arrays are read and written directly
+template <typename T>
+bool readArray(std::istream& in, T* data, std::size_t count) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(data), sizeof(T) * count));
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const T* data, std::size_t count) {
+    out.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+}
+
+const std::int16_t* featureColumn(int index) {
+    return activeNet->featureWeights + index * HIDDEN;
+}
+
+void addColumn(std::int16_t* acc, const std::int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < HIDDEN; ++i) acc[i] = static_cast<std::int16_t>(acc[i] + column[i]);
+#endif
+}
+
+void subColumn(std::int16_t* acc, const std::int16_t* column) {
+#if defined(__AVX2__)
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(column + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+#else
+    for (int i = 0; i < HIDDEN; ++i) acc[i] = static_cast<std::int16_t>(acc[i] - column[i]);
+#endif
+}
+
+// sum(clamp(acc[i], 0, QA) * weights[i])
+std::int32_t clippedDot(const std::int16_t* acc, const std::int16_t* weights) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i qa = _mm256_set1_epi16(QA);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < HIDDEN; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), qa);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i qa = _mm_set1_epi16(QA);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < HIDDEN; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), qa);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+#else
+    std::int32_t sum = 0;
+    for (int i = 0; i < HIDDEN; ++i) sum += std::clamp<std::int32_t>(acc[i], 0, QA) * weights[i];
+    return sum;
+#endif
+}
+
+} // namespace
+
+bool load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    std::uint32_t header[4];
+    if (!readArray(in, header, 4)) return false;
+    if (header[0] != FILE_MAGIC || header[1] != FILE_VERSION ||
+        header[2] != static_cast<std::uint32_t>(INPUTS) || header[3] != static_cast<std::uint32_t>(HIDDEN)) {
+        return false;
+    }
+
+    auto net = std::make_unique<Network>();
+    if (!readArray(in, net->featureWeights, INPUTS * HIDDEN) ||
+        !readArray(in, net->featureBias, HIDDEN) ||
+        !readArray(in, net->outputWeights, 2 * HIDDEN) ||
+        !readArray(in, &net->outputBias, 1)) {
+        return false;
+    }
+    activeNet = std::move(net);
+    return true;
+}
+
+bool isLoaded() {
+    return activeNet != nullptr;
+}
+
+void setNetwork(const Network& net) {
+    if (!activeNet) activeNet = std::make_unique<Network>();
+    std::memcpy(activeNet.get(), &net, sizeof(Network));
+}
+
+bool save(const Network& net, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    const std::uint32_t header[4] = {FILE_MAGIC, FILE_VERSION, INPUTS, HIDDEN};
+    writeArray(out, header, 4);
+    writeArray(out, net.featureWeights, INPUTS * HIDDEN);
+    writeArray(out, net.featureBias, HIDDEN);
+    writeArray(out, net.outputWeights, 2 * HIDDEN);
+    writeArray(out, &net.outputBias, 1);
+    return static_cast<bool>(out);
+}
+
+void resetAccumulator(Accumulator& acc) {
+    for (auto& half : acc.values) {
+        if (activeNet) std::memcpy(half, activeNet->featureBias, sizeof(half));
+        else std::memset(half, 0, sizeof(half));
+    }
+}
+
+void addFeature(Accumulator& acc, int pc, int sq) {
+    addColumn(acc.values[0], featureColumn(featureIndex(Color::WHITE, pc, sq)));
+    addColumn(acc.values[1], featureColumn(featureIndex(Color::BLACK, pc, sq)));
+}
+
+void removeFeature(Accumulator& acc, int pc, int sq) {
+    subColumn(acc.values[0], featureColumn(featureIndex(Color::WHITE, pc, sq)));
+    subColumn(acc.values[1], featureColumn(featureIndex(Color::BLACK, pc, sq)));
+}
+
+int evaluate(const Accumulator& acc, Color sideToMove) {
+    const int us = static_cast<int>(sideToMove);
+    std::int64_t sum = activeNet->outputBias;
+    sum += clippedDot(acc.values[us], activeNet->outputWeights);
+    sum += clippedDot(acc.values[us ^ 1], activeNet->outputWeights + HIDDEN);
+    // Keep well inside the mate range whatever the weights say
+    return static_cast<int>(std::clamp<std::int64_t>(sum * OUTPUT_SCALE / (QA * QB), -20000, 20000));
+}
+
+} // namespace Nnue
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "Bitboard.hpp"
+
+// Efficiently updatable neural evaluation (768 -> 2x256 -> 1).
+//
+// Inputs are (piece colour relative to the perspective, piece type, square)
+// triples, seen once from White's and once from Black's side of the board.
+// The first layer is an int16 accumulator per perspective that Position
+// updates on every putPiece/removePiece, so make/unmake cost a few vector
+// adds. Evaluation clamps both accumulators to [0, QA] (clipped ReLU) and
+// takes a dot product with the output weights, side to move first.
+//
+// Kernels use AVX2 or SSE2 when the compiler targets them and fall back to
+// scalar code otherwise. The weights come from tools/nnue_trainer.
+namespace Nnue {
+
+constexpr int INPUTS = 768;
+constexpr int HIDDEN = 256;
+
+// Quantisation: accumulator units per 1.0 activation, output weight units per 1.0,
+// and centipawns per unit of the float network's output (which is a logit)
+constexpr int QA = 255;
+constexpr int QB = 64;
+constexpr int OUTPUT_SCALE = 400;
+
+// Weight file header
+constexpr std::uint32_t FILE_MAGIC = 0x45554E43; // "CNUE"
+constexpr std::uint32_t FILE_VERSION = 1;
+
+struct alignas(64) Accumulator {
+    std::int16_t values[2][HIDDEN]; // indexed by perspective (Color)
+};
+
+struct Network {
+    alignas(64) std::int16_t featureWeights[INPUTS * HIDDEN];
+    alignas(64) std::int16_t featureBias[HIDDEN];
+    alignas(64) std::int16_t outputWeights[2 * HIDDEN]; // side to move half, then the other side
+    std::int32_t outputBias;
+};
+
+// Input index of piece code pc (see Position.hpp) on sq as seen by perspective
+inline int featureIndex(Color perspective, int pc, int sq) {
+    const int color = pc < 6 ? 0 : 1;
+    const int type = pc % 6;
+    if (perspective == Color::WHITE) return (color * 6 + type) * 64 + sq;
+    return ((color ^ 1) * 6 + type) * 64 + flipRow(sq);
+}
+
+// Load a weight file written by the trainer. Call once at startup, before any
+// Position is set up; returns false (keeping the classical eval) on failure.
+bool load(const std::string& path);
+bool isLoaded();
+
+// Replace the active network (the trainer uses this to check its quantised output)
+void setNetwork(const Network& net);
+
+// Write net in the format load() reads
+bool save(const Network& net, const std::string& path);
+
+// Accumulator maintenance used by Position
+void resetAccumulator(Accumulator& acc);
+void addFeature(Accumulator& acc, int pc, int sq);
+void removeFeature(Accumulator& acc, int pc, int sq);
+
+// Network output in centipawns from sideToMove's point of view
+int evaluate(const Accumulator& acc, Color sideToMove);
+
+} // namespace Nnue
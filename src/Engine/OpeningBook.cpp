@@ -0,0 +1,129 @@
+#include "OpeningBook.hpp"
+#include "PolyglotRandom.hpp"
+
+namespace {
+
+std::uint64_t readBigEndian(const std::uint8_t* p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+void writeBigEndian(std::uint64_t v, std::uint8_t* p, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        p[i] = static_cast<std::uint8_t>(v & 0xFF);
+        v >>= 8;
+    }
+}
+
+// Polyglot counts rows from White's side (a1 = 0); the engine from Black's (a8 = 0)
+int toPolyglotSquare(int sq) { return flipRow(sq); }
+
+// Polyglot piece kind: black pawn, white pawn, black knight, ..., white king
+int polyglotKind(int pc) {
+    static constexpr int KIND_BY_TYPE[6] = {5, 4, 3, 2, 1, 0}; // KING .. PAWN
+    return KIND_BY_TYPE[static_cast<int>(pieceType(pc))] * 2 + (pieceColor(pc) == Color::WHITE ? 1 : 0);
+}
+
+} // namespace
+
+std::uint64_t polyglotKey(const Position& pos) {
+    using namespace PolyglotRandom;
+    std::uint64_t key = 0;
+    for (Bitboard b = pos.pieces(); b;) {
+        int sq = popLsb(b);
+        key ^= RANDOM64[PIECE + 64 * polyglotKind(pos.pieceOn(sq)) + toPolyglotSquare(sq)];
+    }
+    const int rights = pos.castlingRights();
+    if (rights & WHITE_OO) key ^= RANDOM64[CASTLE + 0];
+    if (rights & WHITE_OOO) key ^= RANDOM64[CASTLE + 1];
+    if (rights & BLACK_OO) key ^= RANDOM64[CASTLE + 2];
+    if (rights & BLACK_OOO) key ^= RANDOM64[CASTLE + 3];
+    // Position only records an en passant square when a capture onto it is possible,
+    // which is exactly when Polyglot hashes the file
+    if (pos.epSquare() != NO_SQUARE) key ^= RANDOM64[EN_PASSANT + colOf(pos.epSquare())];
+    if (pos.sideToMove() == Color::WHITE) key ^= RANDOM64[TURN];
+    return key;
+}
+
+std::uint16_t toPolyglotMove(EngineMove m) {
+    const int from = toPolyglotSquare(moveFrom(m));
+    const int to = toPolyglotSquare(moveTo(m));
+    int promo = 0;
+    if (moveKind(m) == MoveKind::PROMOTION) {
+        switch (movePromotion(m)) {
+            case PieceType::KNIGHT: promo = 1; break;
+            case PieceType::BISHOP: promo = 2; break;
+            case PieceType::ROOK: promo = 3; break;
+            default: promo = 4; break;
+        }
+    }
+    return static_cast<std::uint16_t>(to | (from << 6) | (promo << 12));
+}
+
+EngineMove fromPolyglotMove(const Position& pos, std::uint16_t move) {
+    MoveList legal;
+    pos.legalMoves(legal);
+    for (EngineMove m : legal) {
+        if (toPolyglotMove(m) == move) return m;
+    }
+    return NO_MOVE;
+}
+
+void writePolyglotEntry(const PolyglotEntry& e, std::uint8_t* out) {
+    writeBigEndian(e.key, out, 8);
+    writeBigEndian(e.move, out + 8, 2);
+    writeBigEndian(e.weight, out + 10, 2);
+    writeBigEndian(e.learn, out + 12, 4);
+}
+
+bool OpeningBook::open(const std::string& path) {
+    if (!file_.open(path)) return false;
+    if (file_.size() % POLYGLOT_ENTRY_SIZE != 0) {
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+PolyglotEntry OpeningBook::entryAt(std::size_t index) const {
+    const std::uint8_t* p = file_.data() + index * POLYGLOT_ENTRY_SIZE;
+    return {readBigEndian(p, 8), static_cast<std::uint16_t>(readBigEndian(p + 8, 2)),
+            static_cast<std::uint16_t>(readBigEndian(p + 10, 2)), static_cast<std::uint32_t>(readBigEndian(p + 12, 4))};
+}
+
+std::vector<BookMove> OpeningBook::lookup(const Position& pos) const {
+    std::vector<BookMove> moves;
+    if (!isOpen()) return moves;
+
+    // Binary search for the first entry of this position
+    const std::uint64_t key = polyglotKey(pos);
+    std::size_t lo = 0, hi = entryCount();
+    while (lo < hi) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (readBigEndian(file_.data() + mid * POLYGLOT_ENTRY_SIZE, 8) < key) lo = mid + 1;
+        else hi = mid;
+    }
+
+    for (std::size_t i = lo; i < entryCount(); ++i) {
+        PolyglotEntry e = entryAt(i);
+        if (e.key != key) break;
+        EngineMove m = fromPolyglotMove(pos, e.move);
+        if (m != NO_MOVE) moves.push_back({m, e.weight, e.learn});
+    }
+    return moves;
+}
+
+EngineMove OpeningBook::pick(const Position& pos, std::mt19937_64& rng) const {
+    std::vector<BookMove> moves = lookup(pos);
+    std::uint32_t total = 0;
+    for (const BookMove& bm : moves) total += bm.weight;
+    if (total == 0) return NO_MOVE;
+
+    std::uint32_t r = std::uniform_int_distribution<std::uint32_t>(0, total - 1)(rng);
+    for (const BookMove& bm : moves) {
+        if (r < bm.weight) return bm.move;
+        r -= bm.weight;
+    }
+    return NO_MOVE;
+}
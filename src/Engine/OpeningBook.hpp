@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+#include "Position.hpp"
+
+// Polyglot-format opening book (.bin): 16-byte big-endian entries
+// { key u64, move u16, weight u16, learn u32 } sorted by key, several
+// entries per position. The file is memory-mapped and searched in place.
+//
+// Positions are keyed with polyglotKey(), the Polyglot key (piece/square,
+// castling, en passant file, side to move over the Random64 table in
+// PolyglotRandom.hpp), so books made by other Polyglot tools work too.
+
+struct BookMove {
+    EngineMove move;
+    std::uint16_t weight;
+    std::uint32_t learn;
+};
+
+// Raw book entry in host byte order
+struct PolyglotEntry {
+    std::uint64_t key;
+    std::uint16_t move;
+    std::uint16_t weight;
+    std::uint32_t learn;
+};
+
+constexpr std::size_t POLYGLOT_ENTRY_SIZE = 16;
+
+std::uint64_t polyglotKey(const Position& pos);
+
+// Polyglot move encoding <-> engine moves. Castling is "king takes rook" in both.
+std::uint16_t toPolyglotMove(EngineMove m);
+EngineMove fromPolyglotMove(const Position& pos, std::uint16_t move); // NO_MOVE unless legal
+
+// Serialise an entry the way the file stores it (used by the book builder)
+void writePolyglotEntry(const PolyglotEntry& e, std::uint8_t* out);
+
+class OpeningBook {
+public:
+    bool open(const std::string& path);
+    void close() { file_.close(); }
+    bool isOpen() const { return file_.isOpen(); }
+    std::size_t entryCount() const { return file_.size() / POLYGLOT_ENTRY_SIZE; }
+
+    // All legal book moves for the position (empty when out of book)
+    std::vector<BookMove> lookup(const Position& pos) const;
+
+    // Book move picked at random in proportion to its weight, NO_MOVE when out of book
+    EngineMove pick(const Position& pos, std::mt19937_64& rng) const;
+
+private:
+    PolyglotEntry entryAt(std::size_t index) const;
+
+    MappedFile file_;
+};
@@ -0,0 +1,73 @@
+#include "ParallelSearch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+ParallelSearch::ParallelSearch(int threads, std::size_t hashMegabytes) : tt_(hashMegabytes) {
+    setThreads(threads);
+}
+
+void ParallelSearch::setThreads(int threads) {
+    threads = std::max(threads, 1);
+    searches_.resize(1);
+    if (!searches_[0]) searches_[0] = std::make_unique<Search>();
+    while (static_cast<int>(searches_.size()) < threads) searches_.push_back(std::make_unique<Search>());
+    for (std::size_t i = 0; i < searches_.size(); ++i) searches_[i]->shareTable(&tt_, static_cast<int>(i));
+    setIterationCallback(onIteration_);
+}
+
+void ParallelSearch::setIterationCallback(std::function<void(const SearchResult&)> callback) {
+    onIteration_ = std::move(callback);
+    if (!onIteration_) {
+        searches_[0]->setIterationCallback(nullptr);
+        return;
+    }
+    searches_[0]->setIterationCallback([this](const SearchResult& r) {
+        SearchResult total = r;
+        for (std::size_t i = 1; i < searches_.size(); ++i) total.nodes += searches_[i]->nodesSearched();
+        onIteration_(total);
+    });
+}
+
+SearchResult ParallelSearch::think(const Position& root, const SearchLimits& limits) {
+    tt_.newSearch();
+
+    // Helpers run until the main search is done
+    std::vector<std::thread> helpers;
+    std::atomic<int> running{0};
+    if (!limits.nodes) {
+        SearchLimits helperLimits = limits;
+        helperLimits.timeLeftMs = -1;
+        helperLimits.incrementMs = 0;
+        helperLimits.movesToGo = 0;
+        helperLimits.moveTimeMs = 0;
+        helperLimits.multiPv = 1;
+        for (std::size_t i = 1; i < searches_.size(); ++i) {
+            Search* helper = searches_[i].get();
+            ++running;
+            helpers.emplace_back([helper, &root, helperLimits, &running] {
+                helper->think(root, helperLimits);
+                --running;
+            });
+        }
+    }
+
+    SearchResult result = searches_[0]->think(root, limits);
+    // A helper that had not yet started would clear the request, so repeat it until all are back
+    while (running > 0) {
+        for (std::size_t i = 1; i < searches_.size(); ++i) searches_[i]->stop();
+        std::this_thread::yield();
+    }
+    for (auto& t : helpers) t.join();
+    for (std::size_t i = 1; i < searches_.size() && !helpers.empty(); ++i) result.nodes += searches_[i]->nodesSearched();
+    return result;
+}
+
+void ParallelSearch::stop() {
+    for (auto& s : searches_) s->stop();
+}
+
+void ParallelSearch::clear() {
+    for (auto& s : searches_) s->clear();
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Search.hpp"
+#include "TranspositionTable.hpp"
+
+// Lazy SMP: the main Search and a number of helper Searches work on the same
+// root position at once and share one transposition table, so each thread
+// profits from the cutoffs and best moves the others store. Helpers search
+// without limits, skipping alternate depths, and are stopped as soon as the
+// main search returns; only the main search's result is used (with the nodes
+// of all threads). Node-limited searches run on the main thread alone so they
+// stay reproducible.
+class ParallelSearch {
+public:
+    explicit ParallelSearch(int threads = 1, std::size_t hashMegabytes = 16);
+
+    void setThreads(int threads);
+    int threads() const { return static_cast<int>(searches_.size()); }
+
+    // Resizing clears the table
+    void setHashSize(std::size_t megabytes) { tt_.resize(megabytes); }
+    int hashfull() const { return tt_.hashfull(); }
+
+    // See Search::setIterationCallback; nodes count all threads
+    void setIterationCallback(std::function<void(const SearchResult&)> callback);
+
+    SearchResult think(const Position& root, const SearchLimits& limits);
+
+    // Thread safe
+    void stop();
+
+    // New game
+    void clear();
+
+private:
+    TranspositionTable tt_;
+    std::vector<std::unique_ptr<Search>> searches_; // [0] runs on the calling thread
+    std::function<void(const SearchResult&)> onIteration_;
+};
@@ -0,0 +1,115 @@
+#include "PawnTable.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr Psqt::Score DOUBLED_PENALTY{-10, -25};
+constexpr Psqt::Score ISOLATED_PENALTY{-8, -15};
+
+// Passed pawn bonus by rank counted from the pawn's own side (index 1 = starting rank)
+constexpr int PASSED_MG[8] = {0, 5, 10, 15, 30, 50, 80, 0};
+constexpr int PASSED_EG[8] = {0, 10, 20, 35, 60, 100, 150, 0};
+
+// King shelter: penalty for the closest own pawn in front of the king on each of three files,
+// by its distance in rows (0 = no pawn)
+constexpr int SHELTER_PENALTY[4] = {-30, 0, -10, -20};
+
+// Rows strictly in front of a pawn of colour c standing on row r
+Bitboard rowsAhead(Color c, int row) {
+    if (c == Color::WHITE) return (Bitboard(1) << (8 * row)) - 1;
+    return row == 7 ? 0 : ~((Bitboard(1) << (8 * (row + 1))) - 1);
+}
+
+Bitboard adjacentCols(int col) {
+    return (col > 0 ? colBB(col - 1) : 0) | (col < 7 ? colBB(col + 1) : 0);
+}
+
+int relativeRank(Color c, int sq) {
+    return c == Color::WHITE ? 7 - rowOf(sq) : rowOf(sq);
+}
+
+void evaluatePawns(const Position& pos, PawnEntry& e) {
+    e.score = {0, 0};
+    for (Color us : {Color::WHITE, Color::BLACK}) {
+        const Bitboard ours = pos.pieces(us, PieceType::PAWN);
+        const Bitboard theirs = pos.pieces(opposite(us), PieceType::PAWN);
+        const int sign = us == Color::WHITE ? 1 : -1;
+        Bitboard passed = 0;
+
+        for (Bitboard b = ours; b;) {
+            const int sq = popLsb(b);
+            const int col = colOf(sq);
+            const Bitboard ahead = rowsAhead(us, rowOf(sq));
+
+            if (!(ours & adjacentCols(col))) {
+                e.score.mg += sign * ISOLATED_PENALTY.mg;
+                e.score.eg += sign * ISOLATED_PENALTY.eg;
+            }
+            // A pawn with a friendly pawn in front of it is the doubled one; the front pawn may still be passed
+            if (ours & ahead & colBB(col)) {
+                e.score.mg += sign * DOUBLED_PENALTY.mg;
+                e.score.eg += sign * DOUBLED_PENALTY.eg;
+            } else if (!(theirs & ahead & (colBB(col) | adjacentCols(col)))) {
+                passed |= squareBB(sq);
+                const int rank = relativeRank(us, sq);
+                e.score.mg += sign * PASSED_MG[rank];
+                e.score.eg += sign * PASSED_EG[rank];
+            }
+        }
+        e.passed[static_cast<int>(us)] = passed;
+    }
+}
+
+int computeShelter(const Position& pos, Color c, int ksq) {
+    const Bitboard ours = pos.pieces(c, PieceType::PAWN) & rowsAhead(c, rowOf(ksq));
+    const int center = std::clamp(colOf(ksq), 1, 6);
+    int score = 0;
+    for (int col = center - 1; col <= center + 1; ++col) {
+        const Bitboard onCol = ours & colBB(col);
+        if (!onCol) {
+            score += SHELTER_PENALTY[0];
+            continue;
+        }
+        const int nearest = c == Color::WHITE ? msb(onCol) : lsb(onCol);
+        score += SHELTER_PENALTY[std::min(3, std::abs(rowOf(nearest) - rowOf(ksq)))];
+    }
+    return score;
+}
+
+} // namespace
+
+PawnTable::PawnTable(std::size_t entries) {
+    std::size_t size = 1;
+    while (size * 2 <= entries) size *= 2;
+    table_.assign(size, PawnEntry{});
+    mask_ = size - 1;
+}
+
+void PawnTable::clear() {
+    std::fill(table_.begin(), table_.end(), PawnEntry{});
+    resetStats();
+}
+
+PawnEntry& PawnTable::probe(const Position& pos) {
+    ++probes_;
+    PawnEntry& e = table_[pos.pawnKey() & mask_];
+    if (e.key == pos.pawnKey()) {
+        ++hits_;
+        return e;
+    }
+    e = PawnEntry{};
+    e.key = pos.pawnKey();
+    evaluatePawns(pos, e);
+    return e;
+}
+
+int PawnTable::shelter(const Position& pos, PawnEntry& entry, Color c) {
+    const int i = static_cast<int>(c);
+    const int ksq = pos.kingSquare(c);
+    if (entry.kingSquare[i] != ksq) {
+        entry.kingSquare[i] = ksq;
+        entry.shelter[i] = computeShelter(pos, c, ksq);
+    }
+    return entry.shelter[i];
+}
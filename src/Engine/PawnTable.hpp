@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Position.hpp"
+#include "Psqt.hpp"
+
+// Cached pawn-structure evaluation for one pawn configuration
+struct PawnEntry {
+    std::uint64_t key = 0;
+    Psqt::Score score{0, 0};       // doubled, isolated and passed pawns, White's point of view
+    Bitboard passed[2] = {0, 0};   // passed pawns per Color
+
+    // King shelter depends on the king as well, so it is cached for the last
+    // king square seen with this pawn structure and recomputed when it differs
+    int kingSquare[2] = {NO_SQUARE, NO_SQUARE};
+    int shelter[2] = {0, 0};       // middlegame bonus (usually a penalty) for each side
+};
+
+// Hash table of pawn-structure evaluations keyed by Position::pawnKey().
+// Pawns move rarely compared to pieces, so almost every probe is a hit.
+// Not shared between threads: each Search owns one.
+class PawnTable {
+public:
+    explicit PawnTable(std::size_t entries = 16384);
+
+    void clear();
+
+    // Entry for the position's pawns, computed on a miss
+    PawnEntry& probe(const Position& pos);
+
+    // Middlegame king shelter score for c, cached in the entry
+    int shelter(const Position& pos, PawnEntry& entry, Color c);
+
+    std::uint64_t probes() const { return probes_; }
+    std::uint64_t hits() const { return hits_; }
+    void resetStats() { probes_ = hits_ = 0; }
+
+private:
+    std::vector<PawnEntry> table_;
+    std::size_t mask_ = 0;
+    std::uint64_t probes_ = 0;
+    std::uint64_t hits_ = 0;
+};
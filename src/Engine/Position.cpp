@@ -0,0 +1,759 @@
+#include "Position.hpp"
+#include "Psqt.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+using namespace Bitboards;
+
+namespace {
+
+struct ZobristTable {
+    std::uint64_t piece[12][64];
+    std::uint64_t castling[16];
+    std::uint64_t epFile[8];
+    std::uint64_t side;
+};
+
+constexpr std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Keys are generated at compile time from a fixed seed so they are identical on every run
+constexpr ZobristTable makeZobrist() {
+    ZobristTable z{};
+    std::uint64_t state = 0x5EED0C4E55ULL;
+    for (auto& pc : z.piece)
+        for (auto& key : pc) key = splitMix64(state);
+    for (auto& key : z.castling) key = splitMix64(state);
+    for (auto& key : z.epFile) key = splitMix64(state);
+    z.side = splitMix64(state);
+    return z;
+}
+
+constexpr ZobristTable ZOBRIST = makeZobrist();
+
+constexpr char PIECE_CHARS[] = "KQRBNPkqrbnp";
+
+int castlingBit(Color c, bool kingSide) {
+    if (c == Color::WHITE) return kingSide ? WHITE_OO : WHITE_OOO;
+    return kingSide ? BLACK_OO : BLACK_OOO;
+}
+
+int bitIndex(int bit) { return lsb(static_cast<Bitboard>(bit)); }
+
+} // namespace
+
+Position::Position() {
+    history_.reserve(1024);
+    clear();
+}
+
+void Position::clear() {
+    for (int& pc : board_) pc = NO_PIECE;
+    for (Bitboard& b : byType_) b = 0;
+    byColor_[0] = byColor_[1] = 0;
+    side_ = Color::WHITE;
+    castling_ = 0;
+    epSquare_ = NO_SQUARE;
+    halfmove_ = 0;
+    gamePly_ = 0;
+    setVariant(Variant::STANDARD);
+    key_ = 0;
+    pawnKey_ = 0;
+    psqMg_ = psqEg_ = phase_ = 0;
+    Nnue::resetAccumulator(accumulator_);
+    for (int& sq : castlingRook_) sq = NO_SQUARE;
+    for (int& mask : castlingMask_) mask = WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO;
+    history_.clear();
+}
+
+void Position::setVariant(Variant variant) {
+    variant_ = variant;
+    psq_ = variant == Variant::DIAGONAL ? &Psqt::DIAGONAL_PIECE_SQUARE : &Psqt::PIECE_SQUARE;
+}
+
+void Position::putPiece(int sq, int pc) {
+    board_[sq] = pc;
+    byType_[static_cast<int>(pieceType(pc))] |= squareBB(sq);
+    byColor_[static_cast<int>(pieceColor(pc))] |= squareBB(sq);
+    key_ ^= ZOBRIST.piece[pc][sq];
+    if (pieceType(pc) == PieceType::PAWN) pawnKey_ ^= ZOBRIST.piece[pc][sq];
+    psqMg_ += (*psq_)[pc][sq].mg;
+    psqEg_ += (*psq_)[pc][sq].eg;
+    phase_ += Psqt::PHASE_WEIGHT[static_cast<int>(pieceType(pc))];
+    if (Nnue::isLoaded()) Nnue::addFeature(accumulator_, pc, sq);
+}
+
+void Position::removePiece(int sq) {
+    int pc = board_[sq];
+    board_[sq] = NO_PIECE;
+    byType_[static_cast<int>(pieceType(pc))] ^= squareBB(sq);
+    byColor_[static_cast<int>(pieceColor(pc))] ^= squareBB(sq);
+    key_ ^= ZOBRIST.piece[pc][sq];
+    if (pieceType(pc) == PieceType::PAWN) pawnKey_ ^= ZOBRIST.piece[pc][sq];
+    psqMg_ -= (*psq_)[pc][sq].mg;
+    psqEg_ -= (*psq_)[pc][sq].eg;
+    phase_ -= Psqt::PHASE_WEIGHT[static_cast<int>(pieceType(pc))];
+    if (Nnue::isLoaded()) Nnue::removeFeature(accumulator_, pc, sq);
+}
+
+void Position::movePiece(int from, int to) {
+    int pc = board_[from];
+    removePiece(from);
+    putPiece(to, pc);
+}
+
+void Position::addCastlingRight(Color c, int rookSq) {
+    int ksq = kingSquare(c);
+    int bit = castlingBit(c, colOf(rookSq) > colOf(ksq));
+    castling_ |= bit;
+    castlingRook_[bitIndex(bit)] = rookSq;
+    castlingMask_[ksq] &= ~(c == Color::WHITE ? (WHITE_OO | WHITE_OOO) : (BLACK_OO | BLACK_OOO));
+    castlingMask_[rookSq] &= ~bit;
+}
+
+void Position::setEnPassant(int sq) {
+    // Only record the square when the side to move can actually capture there,
+    // so transpositions with and without a pointless double push share a key
+    if (pawnAttacks(opposite(side_), sq) & pieces(side_, PieceType::PAWN)) {
+        epSquare_ = sq;
+        key_ ^= ZOBRIST.epFile[colOf(sq)];
+    }
+}
+
+std::uint64_t Position::computeKey() const {
+    std::uint64_t k = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (board_[sq] != NO_PIECE) k ^= ZOBRIST.piece[board_[sq]][sq];
+    }
+    k ^= ZOBRIST.castling[castling_];
+    if (epSquare_ != NO_SQUARE) k ^= ZOBRIST.epFile[colOf(epSquare_)];
+    if (side_ == Color::BLACK) k ^= ZOBRIST.side;
+    return k;
+}
+
+void Position::setFromGame(const GameLogic& game) {
+    clear();
+    setVariant(game.isChess960Game() ? Variant::CHESS960 : game.isDiagonalGame() ? Variant::DIAGONAL : Variant::STANDARD);
+
+    for (int r = 0; r < 8; ++r) {
+        for (int c = 0; c < 8; ++c) {
+            const Piece* p = game.getPiece(r, c);
+            if (p) putPiece(squareOf(r, c), makePiece(p->color, p->type));
+        }
+    }
+    side_ = game.getTurn();
+
+    // Castling rights come from the hasMoved flags of unmoved kings and rooks on
+    // their home row. Outside Chess960 only the classic e-file king with a/h rooks counts.
+    for (Color c : {Color::WHITE, Color::BLACK}) {
+        if (!pieces(c, PieceType::KING)) continue;
+        int row = (c == Color::WHITE) ? 7 : 0;
+        int ksq = kingSquare(c);
+        const Piece* king = game.getPiece(rowOf(ksq), colOf(ksq));
+        if (rowOf(ksq) != row || king->hasMoved) continue;
+        if (!isChess960() && colOf(ksq) != 4) continue;
+
+        // Walk outwards from the king so the outermost rook wins on each side
+        for (int dir : {-1, 1}) {
+            for (int col = colOf(ksq) + dir; col >= 0 && col < 8; col += dir) {
+                const Piece* rook = game.getPiece(row, col);
+                if (!rook || rook->type != PieceType::ROOK || rook->color != c || rook->hasMoved) continue;
+                if (!isChess960() && col != 0 && col != 7) continue;
+                addCastlingRight(c, squareOf(row, col));
+            }
+        }
+    }
+
+    if (game.isLastMoveDoublePawnPush()) {
+        const Move& last = game.getLastMove();
+        setEnPassant(squareOf((last.r1 + last.r2) / 2, last.c2));
+    }
+
+    key_ = computeKey();
+}
+
+bool Position::setFromFen(const std::string& fen, bool chess960) {
+    return setFromFen(fen, chess960 ? Variant::CHESS960 : Variant::STANDARD);
+}
+
+bool Position::setFromFen(const std::string& fen, Variant variant) {
+    clear();
+    setVariant(variant);
+
+    std::istringstream ss(fen);
+    std::string placement, side, castling = "-", ep = "-";
+    int halfmove = 0, fullmove = 1;
+    if (!(ss >> placement >> side)) return false;
+    ss >> castling >> ep >> halfmove >> fullmove;
+
+    int row = 0, col = 0;
+    for (char ch : placement) {
+        if (ch == '/') {
+            ++row;
+            col = 0;
+        } else if (std::isdigit(static_cast<unsigned char>(ch))) {
+            col += ch - '0';
+        } else {
+            const char* p = std::strchr(PIECE_CHARS, ch);
+            if (!p || row > 7 || col > 7) return false;
+            putPiece(squareOf(row, col), static_cast<int>(p - PIECE_CHARS));
+            ++col;
+        }
+    }
+    if (popCount(pieces(Color::WHITE, PieceType::KING)) != 1 ||
+        popCount(pieces(Color::BLACK, PieceType::KING)) != 1) {
+        return false;
+    }
+
+    side_ = (side == "b") ? Color::BLACK : Color::WHITE;
+
+    for (char ch : castling) {
+        if (ch == '-') break;
+        Color c = std::isupper(static_cast<unsigned char>(ch)) ? Color::WHITE : Color::BLACK;
+        int homeRow = (c == Color::WHITE) ? 7 : 0;
+        int rookPc = makePiece(c, PieceType::ROOK);
+        char up = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        int rookSq = NO_SQUARE;
+
+        if (up == 'K') {
+            for (int f = 7; f > colOf(kingSquare(c)); --f) {
+                if (board_[squareOf(homeRow, f)] == rookPc) { rookSq = squareOf(homeRow, f); break; }
+            }
+        } else if (up == 'Q') {
+            for (int f = 0; f < colOf(kingSquare(c)); ++f) {
+                if (board_[squareOf(homeRow, f)] == rookPc) { rookSq = squareOf(homeRow, f); break; }
+            }
+        } else if (up >= 'A' && up <= 'H') {
+            rookSq = squareOf(homeRow, up - 'A');
+            if (variant_ == Variant::STANDARD) variant_ = Variant::CHESS960; // shares the standard tables
+        }
+        if (rookSq != NO_SQUARE && board_[rookSq] == rookPc && rowOf(kingSquare(c)) == homeRow) {
+            addCastlingRight(c, rookSq);
+        }
+    }
+
+    if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && ep[1] >= '1' && ep[1] <= '8') {
+        setEnPassant(squareOf('8' - ep[1], ep[0] - 'a'));
+    }
+
+    halfmove_ = halfmove;
+    gamePly_ = std::max(0, 2 * (fullmove - 1)) + (side_ == Color::BLACK ? 1 : 0);
+    key_ = computeKey();
+    return true;
+}
+
+std::string Position::toFen() const {
+    std::string fen;
+    for (int row = 0; row < 8; ++row) {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col) {
+            int pc = board_[squareOf(row, col)];
+            if (pc == NO_PIECE) {
+                ++empty;
+                continue;
+            }
+            if (empty) fen += char('0' + empty);
+            empty = 0;
+            fen += PIECE_CHARS[pc];
+        }
+        if (empty) fen += char('0' + empty);
+        if (row < 7) fen += '/';
+    }
+
+    fen += side_ == Color::WHITE ? " w " : " b ";
+
+    std::string rights;
+    const int bits[4] = {WHITE_OO, WHITE_OOO, BLACK_OO, BLACK_OOO};
+    for (int bit : bits) {
+        if (!(castling_ & bit)) continue;
+        char ch;
+        if (isChess960()) ch = static_cast<char>('A' + colOf(castlingRook_[bitIndex(bit)]));
+        else ch = (bit == WHITE_OO || bit == BLACK_OO) ? 'K' : 'Q';
+        if (bit == BLACK_OO || bit == BLACK_OOO) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        rights += ch;
+    }
+    fen += rights.empty() ? "-" : rights;
+
+    fen += ' ';
+    if (epSquare_ == NO_SQUARE) {
+        fen += '-';
+    } else {
+        fen += char('a' + colOf(epSquare_));
+        fen += char('8' - rowOf(epSquare_));
+    }
+
+    fen += ' ' + std::to_string(halfmove_) + ' ' + std::to_string(gamePly_ / 2 + 1);
+    return fen;
+}
+
+Bitboard Position::attackersTo(int sq, Bitboard occupied) const {
+    return (pawnAttacks(Color::WHITE, sq) & pieces(Color::BLACK, PieceType::PAWN)) |
+           (pawnAttacks(Color::BLACK, sq) & pieces(Color::WHITE, PieceType::PAWN)) |
+           (knightAttacks(sq) & pieces(PieceType::KNIGHT)) |
+           (kingAttacks(sq) & pieces(PieceType::KING)) |
+           (rookAttacks(sq, occupied) & (pieces(PieceType::ROOK) | pieces(PieceType::QUEEN))) |
+           (bishopAttacks(sq, occupied) & (pieces(PieceType::BISHOP) | pieces(PieceType::QUEEN)));
+}
+
+bool Position::isSquareAttacked(int sq, Color by) const {
+    return attackersTo(sq, pieces()) & pieces(by);
+}
+
+void Position::castlingSquares(int kingFrom, int rookFrom, int& kingTo, int& rookTo) const {
+    int row = rowOf(kingFrom);
+    bool kingSide = rookFrom > kingFrom;
+    kingTo = squareOf(row, kingSide ? 6 : 2);
+    rookTo = squareOf(row, kingSide ? 5 : 3);
+}
+
+void Position::generateCastling(MoveList& list) const {
+    const Color us = side_;
+    const int ksq = kingSquare(us);
+    const int bits[2] = {castlingBit(us, true), castlingBit(us, false)};
+
+    for (int bit : bits) {
+        if (!(castling_ & bit)) continue;
+        int rsq = castlingRook_[bitIndex(bit)];
+        int kingTo, rookTo;
+        castlingSquares(ksq, rsq, kingTo, rookTo);
+
+        // Every square either piece travels over must be empty, apart from the two castling pieces
+        Bitboard occ = pieces() ^ squareBB(ksq) ^ squareBB(rsq);
+        Bitboard path = between(ksq, kingTo) | squareBB(kingTo) | between(rsq, rookTo) | squareBB(rookTo);
+        if (path & occ) continue;
+
+        // The king may not pass through or land on an attacked square
+        Bitboard kingPath = between(ksq, kingTo) | squareBB(kingTo);
+        bool safe = true;
+        while (kingPath && safe) {
+            if (attackersTo(popLsb(kingPath), occ) & pieces(opposite(us))) safe = false;
+        }
+        if (safe) list.add(encodeMove(ksq, rsq, MoveKind::CASTLING));
+    }
+}
+
+void Position::generate(GenType type, MoveList& list) const {
+    const Color us = side_;
+    const Color them = opposite(us);
+    const Bitboard occ = pieces();
+    const Bitboard enemies = pieces(them);
+    const Bitboard targets = type == GenType::TACTICAL ? enemies
+                           : type == GenType::QUIET    ? ~occ
+                                                       : ~pieces(us);
+    const bool tactical = type != GenType::QUIET;
+    const bool quiet = type != GenType::TACTICAL;
+
+    // Pawns
+    const int forward = (us == Color::WHITE) ? -8 : 8;
+    const int promoRow = (us == Color::WHITE) ? 0 : 7;
+    const int startRow = (us == Color::WHITE) ? 6 : 1;
+    auto addPromotions = [&list](int from, int to) {
+        list.add(encodePromotion(from, to, PieceType::QUEEN));
+        list.add(encodePromotion(from, to, PieceType::KNIGHT));
+        list.add(encodePromotion(from, to, PieceType::ROOK));
+        list.add(encodePromotion(from, to, PieceType::BISHOP));
+    };
+
+    Bitboard pawns = pieces(us, PieceType::PAWN);
+    while (pawns) {
+        int from = popLsb(pawns);
+        int to = from + forward;
+        if (to >= 0 && to < 64 && board_[to] == NO_PIECE) {
+            if (rowOf(to) == promoRow) {
+                if (tactical) addPromotions(from, to);
+            } else if (quiet) {
+                list.add(encodeMove(from, to));
+                int to2 = to + forward;
+                if (rowOf(from) == startRow && board_[to2] == NO_PIECE) list.add(encodeMove(from, to2));
+            }
+        }
+        if (tactical) {
+            Bitboard caps = pawnAttacks(us, from) & enemies;
+            while (caps) {
+                int cap = popLsb(caps);
+                if (rowOf(cap) == promoRow) addPromotions(from, cap);
+                else list.add(encodeMove(from, cap));
+            }
+            if (epSquare_ != NO_SQUARE && (pawnAttacks(us, from) & squareBB(epSquare_))) {
+                list.add(encodeMove(from, epSquare_, MoveKind::EN_PASSANT));
+            }
+        }
+    }
+
+    // Pieces
+    for (PieceType pt : {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN, PieceType::KING}) {
+        Bitboard bb = pieces(us, pt);
+        while (bb) {
+            int from = popLsb(bb);
+            Bitboard attacks;
+            switch (pt) {
+                case PieceType::KNIGHT: attacks = knightAttacks(from); break;
+                case PieceType::BISHOP: attacks = bishopAttacks(from, occ); break;
+                case PieceType::ROOK:   attacks = rookAttacks(from, occ); break;
+                case PieceType::QUEEN:  attacks = rookAttacks(from, occ) | bishopAttacks(from, occ); break;
+                default:                attacks = kingAttacks(from); break;
+            }
+            attacks &= targets;
+            while (attacks) list.add(encodeMove(from, popLsb(attacks)));
+        }
+    }
+
+    if (quiet && castling_ && !inCheck()) generateCastling(list);
+}
+
+bool Position::isLegal(EngineMove m) const {
+    // Castling is fully verified during generation
+    if (moveKind(m) == MoveKind::CASTLING) return true;
+
+    const Color us = side_;
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+
+    Bitboard occ = (pieces() ^ squareBB(from)) | squareBB(to);
+    Bitboard removed = squareBB(to);
+    if (moveKind(m) == MoveKind::EN_PASSANT) {
+        int capSq = to + (us == Color::WHITE ? 8 : -8);
+        occ ^= squareBB(capSq);
+        removed |= squareBB(capSq);
+    }
+
+    int ksq = pieceType(board_[from]) == PieceType::KING ? to : kingSquare(us);
+    return !(attackersTo(ksq, occ) & pieces(opposite(us)) & ~removed);
+}
+
+void Position::legalMoves(MoveList& list) const {
+    MoveList pseudo;
+    generate(GenType::ALL, pseudo);
+    for (EngineMove m : pseudo) {
+        if (isLegal(m)) list.add(m);
+    }
+}
+
+bool Position::isPseudoLegal(EngineMove m) const {
+    if (m == NO_MOVE || m == NULL_MOVE) return false;
+
+    const Color us = side_;
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    const int pc = board_[from];
+    if (pc == NO_PIECE || pieceColor(pc) != us) return false;
+
+    if (moveKind(m) == MoveKind::CASTLING) {
+        if (pieceType(pc) != PieceType::KING || inCheck()) return false;
+        MoveList castles;
+        generateCastling(castles);
+        for (EngineMove c : castles) {
+            if (c == m) return true;
+        }
+        return false;
+    }
+
+    if (board_[to] != NO_PIECE && pieceColor(board_[to]) == us) return false;
+
+    const Bitboard occ = pieces();
+    const PieceType pt = pieceType(pc);
+
+    if (pt == PieceType::PAWN) {
+        const int forward = (us == Color::WHITE) ? -8 : 8;
+        const int promoRow = (us == Color::WHITE) ? 0 : 7;
+        const int startRow = (us == Color::WHITE) ? 6 : 1;
+
+        if (moveKind(m) == MoveKind::EN_PASSANT) {
+            return to == epSquare_ && (pawnAttacks(us, from) & squareBB(to));
+        }
+        if ((rowOf(to) == promoRow) != (moveKind(m) == MoveKind::PROMOTION)) return false;
+
+        if (pawnAttacks(us, from) & squareBB(to)) return board_[to] != NO_PIECE;
+        if (to == from + forward) return board_[to] == NO_PIECE;
+        if (to == from + 2 * forward && rowOf(from) == startRow) {
+            return board_[from + forward] == NO_PIECE && board_[to] == NO_PIECE;
+        }
+        return false;
+    }
+
+    if (moveKind(m) != MoveKind::NORMAL) return false;
+
+    Bitboard attacks;
+    switch (pt) {
+        case PieceType::KNIGHT: attacks = knightAttacks(from); break;
+        case PieceType::BISHOP: attacks = bishopAttacks(from, occ); break;
+        case PieceType::ROOK:   attacks = rookAttacks(from, occ); break;
+        case PieceType::QUEEN:  attacks = rookAttacks(from, occ) | bishopAttacks(from, occ); break;
+        default:                attacks = kingAttacks(from); break;
+    }
+    return attacks & squareBB(to);
+}
+
+bool Position::isCapture(EngineMove m) const {
+    if (moveKind(m) == MoveKind::EN_PASSANT) return true;
+    return moveKind(m) != MoveKind::CASTLING && board_[moveTo(m)] != NO_PIECE;
+}
+
+bool Position::givesCheck(EngineMove m) {
+    doMove(m);
+    bool check = inCheck();
+    undoMove(m);
+    return check;
+}
+
+void Position::doMove(EngineMove m) {
+    history_.push_back({key_, castling_, epSquare_, halfmove_, NO_PIECE});
+
+    const Color us = side_;
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    const MoveKind kind = moveKind(m);
+    const int pc = board_[from];
+    bool doublePush = false;
+
+    if (epSquare_ != NO_SQUARE) {
+        key_ ^= ZOBRIST.epFile[colOf(epSquare_)];
+        epSquare_ = NO_SQUARE;
+    }
+    ++halfmove_;
+    ++gamePly_;
+
+    if (kind == MoveKind::CASTLING) {
+        int kingTo, rookTo;
+        castlingSquares(from, to, kingTo, rookTo);
+        int rook = board_[to];
+        removePiece(from);
+        removePiece(to);
+        putPiece(kingTo, pc);
+        putPiece(rookTo, rook);
+    } else {
+        int capSq = (kind == MoveKind::EN_PASSANT) ? to + (us == Color::WHITE ? 8 : -8) : to;
+        int captured = board_[capSq];
+        if (captured != NO_PIECE) {
+            removePiece(capSq);
+            history_.back().captured = captured;
+            halfmove_ = 0;
+        }
+        movePiece(from, to);
+
+        if (pieceType(pc) == PieceType::PAWN) {
+            halfmove_ = 0;
+            if (kind == MoveKind::PROMOTION) {
+                removePiece(to);
+                putPiece(to, makePiece(us, movePromotion(m)));
+            } else if (std::abs(to - from) == 16) {
+                doublePush = true;
+            }
+        }
+    }
+
+    int rights = castling_ & castlingMask_[from] & castlingMask_[to];
+    if (rights != castling_) {
+        key_ ^= ZOBRIST.castling[castling_] ^ ZOBRIST.castling[rights];
+        castling_ = rights;
+    }
+
+    side_ = opposite(us);
+    key_ ^= ZOBRIST.side;
+
+    if (doublePush) setEnPassant((from + to) / 2);
+}
+
+void Position::undoMove(EngineMove m) {
+    side_ = opposite(side_);
+    --gamePly_;
+    const Color us = side_;
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    const MoveKind kind = moveKind(m);
+    const StateInfo st = history_.back();
+    history_.pop_back();
+
+    if (kind == MoveKind::CASTLING) {
+        int kingTo, rookTo;
+        castlingSquares(from, to, kingTo, rookTo);
+        int king = board_[kingTo];
+        int rook = board_[rookTo];
+        removePiece(kingTo);
+        removePiece(rookTo);
+        putPiece(from, king);
+        putPiece(to, rook);
+    } else {
+        if (kind == MoveKind::PROMOTION) {
+            removePiece(to);
+            putPiece(to, makePiece(us, PieceType::PAWN));
+        }
+        movePiece(to, from);
+        if (st.captured != NO_PIECE) {
+            int capSq = (kind == MoveKind::EN_PASSANT) ? to + (us == Color::WHITE ? 8 : -8) : to;
+            putPiece(capSq, st.captured);
+        }
+    }
+
+    key_ = st.key;
+    castling_ = st.castling;
+    epSquare_ = st.epSquare;
+    halfmove_ = st.halfmove;
+}
+
+void Position::doNullMove() {
+    history_.push_back({key_, castling_, epSquare_, halfmove_, NO_PIECE});
+    if (epSquare_ != NO_SQUARE) {
+        key_ ^= ZOBRIST.epFile[colOf(epSquare_)];
+        epSquare_ = NO_SQUARE;
+    }
+    ++halfmove_;
+    ++gamePly_;
+    side_ = opposite(side_);
+    key_ ^= ZOBRIST.side;
+}
+
+void Position::undoNullMove() {
+    const StateInfo st = history_.back();
+    history_.pop_back();
+    side_ = opposite(side_);
+    --gamePly_;
+    key_ = st.key;
+    epSquare_ = st.epSquare;
+    halfmove_ = st.halfmove;
+}
+
+bool Position::isDraw() const {
+    if (halfmove_ >= 100) return true;
+
+    // Bare kings, or a single minor piece left on the board
+    Bitboard heavy = pieces(PieceType::PAWN) | pieces(PieceType::ROOK) | pieces(PieceType::QUEEN);
+    if (!heavy && popCount(pieces(PieceType::KNIGHT) | pieces(PieceType::BISHOP)) <= 1) return true;
+
+    const int n = static_cast<int>(history_.size());
+    for (int i = 2; i <= halfmove_ && i <= n; i += 2) {
+        if (history_[n - i].key == key_) return true;
+    }
+    return false;
+}
+
+Move Position::toGameMove(EngineMove m) const {
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    Move gm{rowOf(from), colOf(from), rowOf(to), colOf(to)};
+
+    switch (moveKind(m)) {
+        case MoveKind::EN_PASSANT:
+            gm.isEnPassant = true;
+            break;
+        case MoveKind::PROMOTION:
+            gm.isPromotion = true;
+            gm.promotionPiece = movePromotion(m);
+            break;
+        case MoveKind::CASTLING:
+            gm.isCastling = true;
+            // GameLogic's standard castling expects the king's destination column;
+            // its Chess960 branch expects the rook square (king takes rook).
+            if (!isChess960()) gm.c2 = (to > from) ? 6 : 2;
+            break;
+        default:
+            break;
+    }
+    return gm;
+}
+
+std::string Position::toUci(EngineMove m) const {
+    if (m == NO_MOVE) return "0000";
+    int from = moveFrom(m);
+    int to = moveTo(m);
+    if (moveKind(m) == MoveKind::CASTLING && !isChess960()) {
+        to = squareOf(rowOf(from), to > from ? 6 : 2);
+    }
+
+    std::string s;
+    s += char('a' + colOf(from));
+    s += char('8' - rowOf(from));
+    s += char('a' + colOf(to));
+    s += char('8' - rowOf(to));
+    if (moveKind(m) == MoveKind::PROMOTION) {
+        switch (movePromotion(m)) {
+            case PieceType::KNIGHT: s += 'n'; break;
+            case PieceType::BISHOP: s += 'b'; break;
+            case PieceType::ROOK:   s += 'r'; break;
+            default:                s += 'q'; break;
+        }
+    }
+    return s;
+}
+
+std::string Position::toSan(EngineMove m) const {
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    const PieceType type = pieceType(board_[from]);
+    std::string s;
+
+    if (moveKind(m) == MoveKind::CASTLING) {
+        s = to > from ? "O-O" : "O-O-O";
+    } else {
+        static constexpr char LETTERS[6] = {'K', 'Q', 'R', 'B', 'N', 'P'};
+        const bool capture = isCapture(m);
+        if (type == PieceType::PAWN) {
+            if (capture) s += char('a' + colOf(from));
+        } else {
+            s += LETTERS[static_cast<int>(type)];
+            // Other pieces of the same kind that can legally reach the square
+            MoveList list;
+            legalMoves(list);
+            bool ambiguous = false, sameCol = false, sameRow = false;
+            for (EngineMove other : list) {
+                const int f = moveFrom(other);
+                if (f == from || moveTo(other) != to || board_[f] != board_[from] ||
+                    moveKind(other) == MoveKind::CASTLING) {
+                    continue;
+                }
+                ambiguous = true;
+                sameCol = sameCol || colOf(f) == colOf(from);
+                sameRow = sameRow || rowOf(f) == rowOf(from);
+            }
+            if (ambiguous) {
+                if (!sameCol) s += char('a' + colOf(from));
+                else if (!sameRow) s += char('8' - rowOf(from));
+                else {
+                    s += char('a' + colOf(from));
+                    s += char('8' - rowOf(from));
+                }
+            }
+        }
+        if (capture) s += 'x';
+        s += char('a' + colOf(to));
+        s += char('8' - rowOf(to));
+        if (moveKind(m) == MoveKind::PROMOTION) {
+            s += '=';
+            s += LETTERS[static_cast<int>(movePromotion(m))];
+        }
+    }
+
+    Position after = *this;
+    after.doMove(m);
+    if (after.inCheck()) {
+        MoveList replies;
+        after.legalMoves(replies);
+        s += replies.size ? '+' : '#';
+    }
+    return s;
+}
+
+EngineMove Position::parseUci(const std::string& str) const {
+    MoveList list;
+    legalMoves(list);
+    for (EngineMove m : list) {
+        if (toUci(m) == str) return m;
+        // Accept king-takes-rook castling notation in standard games too
+        if (moveKind(m) == MoveKind::CASTLING && str.size() == 4) {
+            std::string alt;
+            alt += char('a' + colOf(moveFrom(m)));
+            alt += char('8' - rowOf(moveFrom(m)));
+            alt += char('a' + colOf(moveTo(m)));
+            alt += char('8' - rowOf(moveTo(m)));
+            if (alt == str) return m;
+        }
+    }
+    return NO_MOVE;
+}
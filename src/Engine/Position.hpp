@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Bitboard.hpp"
+#include "Nnue.hpp"
+#include "Psqt.hpp"
+#include "../GameLogic.hpp"
+
+// Compact 16-bit move used by the search:
+//   bits 0-5 from square, 6-11 to square, 12-13 promotion piece, 14-15 kind.
+// Castling is encoded as "king takes own rook" (to = rook square), the same
+// convention King::isPseudoLegal uses, so it works for Chess960 as well.
+using EngineMove = std::uint16_t;
+
+enum class MoveKind { NORMAL = 0, PROMOTION = 1, EN_PASSANT = 2, CASTLING = 3 };
+
+constexpr EngineMove NO_MOVE = 0;
+constexpr EngineMove NULL_MOVE = 65; // from == to == b8, never a real move
+
+constexpr int moveFrom(EngineMove m) { return m & 0x3F; }
+constexpr int moveTo(EngineMove m) { return (m >> 6) & 0x3F; }
+constexpr MoveKind moveKind(EngineMove m) { return static_cast<MoveKind>(m >> 14); }
+
+// Promotion piece is stored as 0..3 = KNIGHT, BISHOP, ROOK, QUEEN
+inline PieceType movePromotion(EngineMove m) {
+    static constexpr PieceType types[4] = {PieceType::KNIGHT, PieceType::BISHOP, PieceType::ROOK, PieceType::QUEEN};
+    return types[(m >> 12) & 3];
+}
+
+constexpr EngineMove encodeMove(int from, int to, MoveKind kind = MoveKind::NORMAL) {
+    return static_cast<EngineMove>(from | (to << 6) | (static_cast<int>(kind) << 14));
+}
+
+inline EngineMove encodePromotion(int from, int to, PieceType promo) {
+    int code = promo == PieceType::KNIGHT ? 0 : promo == PieceType::BISHOP ? 1 : promo == PieceType::ROOK ? 2 : 3;
+    return static_cast<EngineMove>(encodeMove(from, to, MoveKind::PROMOTION) | (code << 12));
+}
+
+// Piece codes stored in the mailbox: color * 6 + type, NO_PIECE for empty squares
+constexpr int NO_PIECE = 12;
+
+constexpr int makePiece(Color c, PieceType t) { return static_cast<int>(c) * 6 + static_cast<int>(t); }
+constexpr Color pieceColor(int pc) { return pc < 6 ? Color::WHITE : Color::BLACK; }
+constexpr PieceType pieceType(int pc) { return static_cast<PieceType>(pc % 6); }
+
+// Fixed-capacity move list (no legal chess position has more than 218 moves)
+struct MoveList {
+    EngineMove moves[256];
+    int size = 0;
+
+    void add(EngineMove m) { moves[size++] = m; }
+    EngineMove* begin() { return moves; }
+    EngineMove* end() { return moves + size; }
+    const EngineMove* begin() const { return moves; }
+    const EngineMove* end() const { return moves + size; }
+};
+
+// Which moves generate() produces. TACTICAL = captures + promotions, QUIET = everything else.
+enum class GenType { TACTICAL, QUIET, ALL };
+
+// Starting setups from the menu. They share the move rules (Chess960 castling is
+// king-takes-rook for any king and rook files) but not the evaluation tables.
+enum class Variant { STANDARD, CHESS960, DIAGONAL };
+
+constexpr int WHITE_OO = 1, WHITE_OOO = 2, BLACK_OO = 4, BLACK_OOO = 8;
+
+// Bitboard position with make/unmake used by the bot's search.
+// GameLogic stays the authority for the GUI; a Position is built from it
+// (or from FEN) and searched independently, so it is safe to hand a copy
+// to a worker thread.
+class Position {
+public:
+    Position();
+
+    // Load the current state of a GUI game
+    void setFromGame(const GameLogic& game);
+
+    // Load a FEN string (Shredder/X-FEN castling letters accepted). Returns false on malformed input.
+    bool setFromFen(const std::string& fen, bool chess960 = false);
+    bool setFromFen(const std::string& fen, Variant variant);
+    std::string toFen() const;
+
+    // Board queries
+    int pieceOn(int sq) const { return board_[sq]; }
+    Bitboard pieces() const { return byColor_[0] | byColor_[1]; }
+    Bitboard pieces(Color c) const { return byColor_[static_cast<int>(c)]; }
+    Bitboard pieces(PieceType t) const { return byType_[static_cast<int>(t)]; }
+    Bitboard pieces(Color c, PieceType t) const { return pieces(c) & pieces(t); }
+    int kingSquare(Color c) const { return lsb(pieces(c, PieceType::KING)); }
+    Color sideToMove() const { return side_; }
+    int epSquare() const { return epSquare_; }
+    int castlingRights() const { return castling_; }
+    int halfmoveClock() const { return halfmove_; }
+    int gamePly() const { return gamePly_; }
+    void setGamePly(int ply) { gamePly_ = ply; }
+    Variant variant() const { return variant_; }
+    bool isChess960() const { return variant_ == Variant::CHESS960; }
+    std::uint64_t key() const { return key_; }
+    std::uint64_t pawnKey() const { return pawnKey_; }   // pawns only, for the pawn hash
+
+    // Running material + piece-square sums (White's point of view) and game phase, see Psqt.hpp
+    int psqMg() const { return psqMg_; }
+    int psqEg() const { return psqEg_; }
+    int phase() const { return phase_; }
+
+    // First layer of the neural evaluator, kept in sync while a network is loaded
+    const Nnue::Accumulator& accumulator() const { return accumulator_; }
+
+    // Attack queries
+    Bitboard attackersTo(int sq, Bitboard occupied) const;
+    bool isSquareAttacked(int sq, Color by) const;
+    bool inCheck() const { return isSquareAttacked(kingSquare(side_), opposite(side_)); }
+
+    // Move generation (pseudo-legal; filter with isLegal) and legal move list
+    void generate(GenType type, MoveList& list) const;
+    void legalMoves(MoveList& list) const;
+    bool isLegal(EngineMove m) const;
+    bool isPseudoLegal(EngineMove m) const;
+    bool isCapture(EngineMove m) const;
+    bool givesCheck(EngineMove m);
+
+    // Make / unmake
+    void doMove(EngineMove m);
+    void undoMove(EngineMove m);
+    void doNullMove();
+    void undoNullMove();
+
+    // Draw by fifty-move rule or repetition since the last irreversible move
+    bool isDraw() const;
+
+    // Conversion between engine moves and GameLogic / UCI moves
+    Move toGameMove(EngineMove m) const;
+    std::string toUci(EngineMove m) const;
+    // Standard algebraic notation with disambiguation and check/mate suffix (m must be legal)
+    std::string toSan(EngineMove m) const;
+    EngineMove parseUci(const std::string& str) const;
+
+private:
+    struct StateInfo {
+        std::uint64_t key;
+        int castling;
+        int epSquare;
+        int halfmove;
+        int captured;
+    };
+
+    void clear();
+    void setVariant(Variant variant);
+    void putPiece(int sq, int pc);
+    void removePiece(int sq);
+    void movePiece(int from, int to);
+    void addCastlingRight(Color c, int rookSq);
+    void generateCastling(MoveList& list) const;
+    void castlingSquares(int kingFrom, int rookFrom, int& kingTo, int& rookTo) const;
+    void setEnPassant(int sq);
+    std::uint64_t computeKey() const;
+
+    int board_[64];
+    Bitboard byType_[6];
+    Bitboard byColor_[2];
+    Color side_;
+    int castling_;
+    int epSquare_;
+    int halfmove_;
+    int gamePly_;
+    Variant variant_;
+    const Psqt::PieceTable* psq_;   // the variant's tables, see Psqt.hpp
+    std::uint64_t key_;
+    std::uint64_t pawnKey_;
+    int psqMg_;
+    int psqEg_;
+    int phase_;
+    Nnue::Accumulator accumulator_;
+
+    // Castling rook squares per right (indexed by bit position) and the
+    // rights that survive a move touching each square
+    int castlingRook_[4];
+    int castlingMask_[64];
+
+    std::vector<StateInfo> history_;
+};
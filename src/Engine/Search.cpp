@@ -0,0 +1,431 @@
+#include "Search.hpp"
+#include "Evaluate.hpp"
+#include "See.hpp"
+#include "Tablebase.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+constexpr int RAZOR_MARGIN = 300;             // per ply of remaining depth
+constexpr int REVERSE_FUTILITY_MARGIN = 90;   // per ply
+constexpr int FUTILITY_BASE = 100, FUTILITY_MARGIN = 100;
+
+// Late-move reductions in plies by [depth][move number]: later moves in the
+// ordering are less likely to matter, and more so the deeper the search
+const auto LMR_TABLE = [] {
+    std::array<std::array<int, 64>, 64> t{};
+    for (int d = 1; d < 64; ++d)
+        for (int n = 1; n < 64; ++n) t[d][n] = static_cast<int>(0.75 + std::log(d) * std::log(n) / 2.25);
+    return t;
+}();
+
+} // namespace
+
+Search::Search() {
+    clear();
+}
+
+void Search::shareTable(TranspositionTable* shared, int helperId) {
+    tt_ = shared ? shared : &ownTt_;
+    helperId_ = helperId;
+    // The own table is unused meanwhile: keep it at the minimum size
+    ownTt_.resize(shared ? 1 : 16);
+}
+
+void Search::clear() {
+    tt_->clear();
+    history_.clear();
+    pawns_.clear();
+}
+
+MoveList rootMoves(const Position& pos, const SearchLimits& limits) {
+    MoveList legal, allowed;
+    pos.legalMoves(legal);
+    for (EngineMove m : legal) {
+        if (std::find(limits.searchMoves.begin(), limits.searchMoves.end(), m) != limits.searchMoves.end()) allowed.add(m);
+    }
+    return allowed.size ? allowed : legal;
+}
+
+SearchResult Search::think(const Position& root, const SearchLimits& limits) {
+    pos_ = root;
+    limits_ = limits;
+    time_.init(limits, root.gamePly());
+    // The generation of a shared table is advanced by its owner
+    if (tt_ == &ownTt_) tt_->newSearch();
+    history_.age();
+    stopRequested_ = false;
+    aborted_ = false;
+    nodes_ = 0;
+    publishedNodes_ = 0;
+    selDepth_ = 0;
+    stats_ = SearchStats{};
+    pawns_.resetStats();
+    prevBest_ = NO_MOVE;
+    for (auto& k : killers_) k[0] = k[1] = NO_MOVE;
+
+    SearchResult result;
+    const MoveList allowed = rootMoves(pos_, limits);
+    if (allowed.size == 0) return result;
+    result.bestMove = allowed.moves[0];
+
+    // Root moves outside searchmoves are skipped like the lines multi-PV has already reported
+    std::vector<EngineMove> rootSkipped;
+    MoveList legal;
+    pos_.legalMoves(legal);
+    for (EngineMove m : legal) {
+        if (std::find(allowed.begin(), allowed.end(), m) == allowed.end()) rootSkipped.push_back(m);
+    }
+
+    const int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    const int lineCount = std::clamp(limits.multiPv, 1, allowed.size);
+    std::int64_t iterationStart = 0;
+    std::uint64_t iterationStartNodes = 0;
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        // Helpers skip every other depth (odd and even helpers alternate) to spread out
+        if (helperId_ > 0 && depth > 1 && depth < maxDepth && (depth + helperId_) % 2 == 0) continue;
+
+        std::vector<SearchLine> lines;
+        rootExcluded_ = rootSkipped;
+        for (int pvIdx = 0; pvIdx < lineCount; ++pvIdx) {
+            rootBest_ = NO_MOVE;
+            int score = negamax(depth, -VALUE_INFINITE, VALUE_INFINITE, 0);
+            if (aborted_) break;
+            lines.push_back({pv_[0][0], score, depth, std::vector<EngineMove>(pv_[0], pv_[0] + pvLength_[0])});
+            rootExcluded_.push_back(pv_[0][0]);
+        }
+
+        if (aborted_) {
+            // A partially searched iteration is still usable once its first
+            // (previously best) root move has been fully searched
+            if (lines.empty() && rootBest_ != NO_MOVE) {
+                result.bestMove = rootBest_;
+                result.score = rootBestScore_;
+                if (result.pv.empty() || result.pv[0] != rootBest_) result.pv.assign(1, rootBest_);
+                if (result.lines.empty() || result.lines[0].move != rootBest_)
+                    result.lines.assign(1, SearchLine{rootBest_, rootBestScore_, depth - 1, result.pv});
+            }
+            break;
+        }
+
+        // Later lines are searched after the better ones, so order can only break on instability
+        std::stable_sort(lines.begin(), lines.end(),
+                         [](const SearchLine& a, const SearchLine& b) { return a.score > b.score; });
+        const int score = lines[0].score;
+        const std::int64_t now = time_.elapsedMs();
+        const bool changed = lines[0].move != prevBest_;
+        result.bestMove = lines[0].move;
+        result.score = score;
+        result.depth = depth;
+        result.pv = lines[0].pv;
+        result.lines = std::move(lines);
+        prevBest_ = result.bestMove;
+        stats_.prevIterationNodes = stats_.lastIterationNodes;
+        stats_.lastIterationNodes = nodes_ - iterationStartNodes;
+        iterationStartNodes = nodes_;
+        if (onIteration_) {
+            result.nodes = nodes_;
+            result.selDepth = selDepth_;
+            result.timeMs = now;
+            result.stats = stats_;
+            onIteration_(result);
+        }
+
+        // A forced mate needs no deeper search (unless the other lines are wanted)
+        if (lineCount == 1 && std::abs(score) >= VALUE_MATE_IN_MAX_PLY) break;
+        if (!time_.continueIterating(now - iterationStart, changed, score)) break;
+        iterationStart = now;
+    }
+
+    result.nodes = nodes_;
+    publishedNodes_ = nodes_;
+    result.selDepth = selDepth_;
+    result.timeMs = time_.elapsedMs();
+    stats_.pawnProbes = pawns_.probes();
+    stats_.pawnHits = pawns_.hits();
+    result.stats = stats_;
+    return result;
+}
+
+// Static evaluation, blurred for the weaker strength levels. The noise is a hash of
+// the position and the seed, so transpositions agree and searches stay reproducible.
+int Search::staticEval() {
+    int eval = evaluate(pos_, pawns_);
+    if (limits_.evalNoise > 0) {
+        std::uint64_t h = (pos_.key() ^ limits_.noiseSeed) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 31;
+        eval += static_cast<int>(h % (2 * limits_.evalNoise + 1)) - limits_.evalNoise;
+    }
+    return eval;
+}
+
+bool Search::shouldAbort() {
+    if (aborted_) return true;
+    if ((nodes_ & 1023) == 0) {
+        publishedNodes_.store(nodes_, std::memory_order_relaxed);
+        if (stopRequested_ || time_.hardLimitReached()) aborted_ = true;
+    }
+    if (limits_.nodes && nodes_ >= limits_.nodes) aborted_ = true;
+    return aborted_;
+}
+
+void Search::updateQuietStats(EngineMove best, int depth, int ply, const EngineMove* quiets, int quietCount) {
+    if (killers_[ply][0] != best) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = best;
+    }
+
+    if (ply > 0 && moveStack_[ply - 1] != NULL_MOVE)
+        history_.counter[movedPiece_[ply - 1]][moveTo(moveStack_[ply - 1])] = best;
+
+    // Reward the refutation, penalise the quiet moves tried before it
+    const int bonus = std::min(depth * depth, 400);
+    const Color us = pos_.sideToMove();
+    history_.updateQuiet(us, best, bonus);
+    for (int i = 0; i < quietCount; ++i) history_.updateQuiet(us, quiets[i], -bonus);
+}
+
+int Search::negamax(int depth, int alpha, int beta, int ply) {
+    if (depth <= 0) return quiescence(alpha, beta, ply);
+
+    const bool pvNode = beta - alpha > 1;
+    pvLength_[ply] = ply;
+
+    ++nodes_;
+    selDepth_ = std::max(selDepth_, ply);
+    if (shouldAbort()) return 0;
+
+    if (ply > 0 && pos_.isDraw()) return 0;
+    if (ply >= MAX_PLY) return staticEval();
+    const bool inCheck = pos_.inCheck();
+
+    // Solved endgame: score by distance to mate, as if the search had found it
+    TbResult tb;
+    if (ply > 0 && popCount(pos_.pieces()) <= Tablebase::maxPieces() && Tablebase::probe(pos_, tb)) {
+        ++stats_.tbHits;
+        if (tb.wdl == 0) return 0;
+        return tb.wdl > 0 ? VALUE_MATE - (ply + 2 * tb.dtm - 1) : -VALUE_MATE + ply + 2 * tb.dtm;
+    }
+
+    // Transposition table: cut off at non-PV nodes, otherwise just borrow the move
+    TTEntry tte;
+    ++stats_.ttProbes;
+    const bool ttHit = tt_->probe(pos_.key(), tte);
+    EngineMove ttMove = NO_MOVE;
+    if (ttHit) {
+        ++stats_.ttHits;
+        ttMove = tte.move;
+        int ttScore = scoreFromTT(tte.score, ply);
+        if (!pvNode && tte.depth >= depth &&
+            (tte.bound == Bound::EXACT ||
+             (tte.bound == Bound::LOWER && ttScore >= beta) ||
+             (tte.bound == Bound::UPPER && ttScore <= alpha))) {
+            return ttScore;
+        }
+    }
+    if (ply == 0 && ttMove == NO_MOVE) ttMove = prevBest_;
+
+    // Static evaluation for the pruning decisions, sharpened by a matching hash bound
+    int eval = -VALUE_INFINITE;
+    if (!inCheck && !pvNode) {
+        eval = staticEval();
+        if (ttHit) {
+            const int ttScore = scoreFromTT(tte.score, ply);
+            if (tte.bound == (ttScore > eval ? Bound::LOWER : Bound::UPPER) || tte.bound == Bound::EXACT) eval = ttScore;
+        }
+    }
+
+    if (!pvNode && !inCheck && ply > 0 && std::abs(beta) < VALUE_MATE_IN_MAX_PLY) {
+        // Razoring: hopelessly behind near the leaves, only a capture sequence could help
+        if (limits_.razoring && depth <= 2 && eval + RAZOR_MARGIN * depth <= alpha) {
+            const int score = quiescence(alpha, alpha + 1, ply);
+            if (aborted_) return 0;
+            if (score <= alpha) {
+                ++stats_.razorCuts;
+                return score;
+            }
+        }
+
+        // Reverse futility: so far ahead that one quiet move by the opponent cannot undo it
+        if (limits_.futility && depth <= 6 && eval - REVERSE_FUTILITY_MARGIN * depth >= beta) {
+            ++stats_.futilityPrunes;
+            return eval;
+        }
+
+        // Null move: if passing still fails high, a real move will too. Not with only
+        // king and pawns, where zugzwang is common and passing would be the best move
+        const Color us = pos_.sideToMove();
+        const Bitboard nonPawn = pos_.pieces(us) & ~pos_.pieces(us, PieceType::PAWN) & ~pos_.pieces(us, PieceType::KING);
+        if (limits_.nullMove && depth >= 3 && eval >= beta && nonPawn && moveStack_[ply - 1] != NULL_MOVE) {
+            const int r = 3 + depth / 4;
+            moveStack_[ply] = NULL_MOVE;
+            movedPiece_[ply] = NO_PIECE;
+            pos_.doNullMove();
+            int score = -negamax(depth - 1 - r, -beta, -beta + 1, ply + 1);
+            pos_.undoNullMove();
+            if (aborted_) return 0;
+            if (score >= beta) {
+                ++stats_.nullCutoffs;
+                // Mates found after passing are not proven
+                return score >= VALUE_MATE_IN_MAX_PLY ? beta : score;
+            }
+        }
+    }
+
+    // Quiet moves that cannot lift a lost-looking frontier node to alpha are skipped
+    const bool futileNode = limits_.futility && !pvNode && !inCheck && ply > 0 && depth <= 3 &&
+                            eval + FUTILITY_BASE + FUTILITY_MARGIN * depth <= alpha;
+
+    EngineMove counterMove = NO_MOVE;
+    if (ply > 0 && moveStack_[ply - 1] != NULL_MOVE)
+        counterMove = history_.counter[movedPiece_[ply - 1]][moveTo(moveStack_[ply - 1])];
+
+    MovePicker picker(pos_, ttMove, killers_[ply], counterMove, history_);
+    const int alphaOrig = alpha;
+    int bestScore = -VALUE_INFINITE;
+    EngineMove bestMove = NO_MOVE;
+    int legalCount = 0;
+    EngineMove quietsTried[64];
+    int quietCount = 0;
+
+    EngineMove m;
+    while ((m = picker.next()) != NO_MOVE) {
+        if (!pos_.isLegal(m)) continue;
+        if (ply == 0 && std::find(rootExcluded_.begin(), rootExcluded_.end(), m) != rootExcluded_.end()) continue;
+        ++legalCount;
+        const bool quiet = !pos_.isCapture(m) && moveKind(m) != MoveKind::PROMOTION;
+
+        // Only late quiet moves (after the hash move, killers and counter move) are
+        // pruned or reduced, and never checks
+        const bool late = quiet && legalCount > 1 && !inCheck && picker.stage() == PickStage::QUIETS;
+        const bool reducible = late && limits_.lateMoveReductions && depth >= 3 && legalCount > (pvNode ? 3 : 2);
+        const bool checks = (late && (futileNode || reducible)) && pos_.givesCheck(m);
+        if (late && futileNode && !checks && bestScore > -VALUE_MATE_IN_MAX_PLY) {
+            ++stats_.futilityPrunes;
+            continue;
+        }
+
+        moveStack_[ply] = m;
+        movedPiece_[ply] = pos_.pieceOn(moveFrom(m));
+        pos_.doMove(m);
+        int score;
+        if (legalCount == 1) {
+            score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            // Late quiet moves get less depth, less still when their history is poor
+            int r = 0;
+            if (reducible && !checks) {
+                r = LMR_TABLE[std::min(depth, 63)][std::min(legalCount, 63)];
+                r -= history_.butterfly[static_cast<int>(opposite(pos_.sideToMove()))][moveFrom(m)][moveTo(m)] / 8192;
+                if (pvNode) --r;
+                r = std::clamp(r, 0, depth - 2);
+                if (r > 0) ++stats_.lmrReductions;
+            }
+
+            // Later moves only need to prove they are no better than the first
+            score = -negamax(depth - 1 - r, -alpha - 1, -alpha, ply + 1);
+            if (r > 0 && score > alpha) {
+                ++stats_.lmrReSearches;
+                score = -negamax(depth - 1, -alpha - 1, -alpha, ply + 1);
+            }
+            if (score > alpha && score < beta) score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+        }
+        pos_.undoMove(m);
+
+        if (aborted_) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = m;
+            if (score > alpha) {
+                alpha = score;
+                pv_[ply][ply] = m;
+                for (int i = ply + 1; i < pvLength_[ply + 1]; ++i) pv_[ply][i] = pv_[ply + 1][i];
+                pvLength_[ply] = pvLength_[ply + 1];
+                if (ply == 0) {
+                    rootBest_ = m;
+                    rootBestScore_ = score;
+                }
+                if (alpha >= beta) {
+                    ++stats_.betaCutoffs;
+                    if (legalCount == 1) ++stats_.firstMoveCutoffs;
+                    ++stats_.cutoffsByStage[static_cast<int>(picker.stage())];
+                    if (quiet) updateQuietStats(m, depth, ply, quietsTried, quietCount);
+                    break;
+                }
+            }
+        }
+        if (quiet && quietCount < 64) quietsTried[quietCount++] = m;
+    }
+
+    if (legalCount == 0) return inCheck ? -VALUE_MATE + ply : 0;
+
+    // A root search with moves excluded (multi-PV, searchmoves) does not describe the position
+    if (ply == 0 && !rootExcluded_.empty()) return bestScore;
+
+    Bound bound = bestScore >= beta ? Bound::LOWER : bestScore > alphaOrig ? Bound::EXACT : Bound::UPPER;
+    tt_->store(pos_.key(), bound == Bound::UPPER ? NO_MOVE : bestMove, scoreToTT(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+int Search::quiescence(int alpha, int beta, int ply) {
+    pvLength_[ply] = ply;
+
+    ++nodes_;
+    ++stats_.qsNodes;
+    selDepth_ = std::max(selDepth_, ply);
+    if (shouldAbort()) return 0;
+    if (ply >= MAX_PLY) return staticEval();
+
+    // Resolve only captures and promotions; when in check every evasion is searched
+    const bool inCheck = pos_.inCheck();
+    int bestScore = -VALUE_INFINITE;
+    int standPat = 0;
+    if (!inCheck) {
+        standPat = staticEval();
+        if (standPat >= beta) return standPat;
+        if (standPat > alpha) alpha = standPat;
+        bestScore = standPat;
+    }
+
+    MovePicker picker(pos_, inCheck, history_);
+    int legalCount = 0;
+    EngineMove m;
+    while ((m = picker.next()) != NO_MOVE) {
+        if (!pos_.isLegal(m)) continue;
+        ++legalCount;
+
+        if (!inCheck) {
+            // Captures that lose material in the exchange cannot raise alpha
+            if (moveKind(m) != MoveKind::PROMOTION && staticExchange(pos_, m) < 0) continue;
+
+            // Delta pruning: even winning the victim outright stays below alpha
+            if (moveKind(m) != MoveKind::PROMOTION) {
+                int victim = moveKind(m) == MoveKind::EN_PASSANT ? pieceValue(PieceType::PAWN)
+                                                                  : pieceValue(pieceType(pos_.pieceOn(moveTo(m))));
+                if (standPat + victim + 200 <= alpha) continue;
+            }
+        }
+
+        pos_.doMove(m);
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        pos_.undoMove(m);
+
+        if (aborted_) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    if (inCheck && legalCount == 0) return -VALUE_MATE + ply;
+    return bestScore;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "Position.hpp"
+#include "TimeManager.hpp"
+#include "MovePicker.hpp"
+#include "TranspositionTable.hpp"
+#include "PawnTable.hpp"
+
+constexpr int MAX_PLY = 64;
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+// Counters collected during one think() call, mainly for tuning move ordering
+struct SearchStats {
+    std::uint64_t betaCutoffs = 0;        // fail-highs in the main search
+    std::uint64_t firstMoveCutoffs = 0;   // ... caused by the first legal move tried
+    std::uint64_t cutoffsByStage[PICK_STAGE_COUNT] = {};
+    std::uint64_t ttProbes = 0;
+    std::uint64_t ttHits = 0;
+    std::uint64_t qsNodes = 0;
+    std::uint64_t pawnProbes = 0;
+    std::uint64_t pawnHits = 0;
+    std::uint64_t tbHits = 0;             // nodes answered by the endgame tablebases
+    std::uint64_t nullCutoffs = 0;        // fail-highs proven by a null move
+    std::uint64_t futilityPrunes = 0;     // nodes and moves cut by (reverse) futility
+    std::uint64_t razorCuts = 0;
+    std::uint64_t lmrReductions = 0;      // moves searched at reduced depth
+    std::uint64_t lmrReSearches = 0;      // ... that beat alpha and were searched again
+    std::uint64_t lastIterationNodes = 0; // nodes of the last completed iteration
+    std::uint64_t prevIterationNodes = 0; // ... and of the one before it
+
+    // Share of cutoffs found by the first move; well-ordered searches reach 0.9+
+    double firstMoveCutoffRate() const { return betaCutoffs ? double(firstMoveCutoffs) / betaCutoffs : 0.0; }
+    double ttHitRate() const { return ttProbes ? double(ttHits) / ttProbes : 0.0; }
+    double pawnHitRate() const { return pawnProbes ? double(pawnHits) / pawnProbes : 0.0; }
+    // Growth of the tree per extra ply of depth; pruning and ordering keep it low
+    double effectiveBranching() const {
+        return prevIterationNodes ? double(lastIterationNodes) / prevIterationNodes : 0.0;
+    }
+};
+
+// One analysed root move
+struct SearchLine {
+    EngineMove move = NO_MOVE;
+    int score = 0;                  // centipawns from the side to move's point of view
+    int depth = 0;
+    std::vector<EngineMove> pv;     // starts with move
+};
+
+struct SearchResult {
+    EngineMove bestMove = NO_MOVE;
+    int score = 0;                  // centipawns from the side to move's point of view
+    int depth = 0;                  // last completed iteration
+    int selDepth = 0;               // deepest ply reached, quiescence included
+    std::uint64_t nodes = 0;
+    std::int64_t timeMs = 0;
+    std::vector<EngineMove> pv;
+    std::vector<SearchLine> lines;  // best limits.multiPv root moves, best first (lines[0] matches bestMove)
+    SearchStats stats;
+
+    std::uint64_t nodesPerSecond() const { return nodes * 1000 / static_cast<std::uint64_t>(std::max<std::int64_t>(timeMs, 1)); }
+};
+
+// Legal moves a search may play from pos: those in limits.searchMoves, or all of them
+// when the list is empty or names no legal move
+MoveList rootMoves(const Position& pos, const SearchLimits& limits);
+
+// Iterative-deepening principal variation search over a Position. Null-move
+// pruning, late-move reductions, futility pruning and razoring skip lines that
+// cannot matter; each can be switched off in SearchLimits.
+class Search {
+public:
+    Search();
+
+    // Search the given position within the limits and return the best move found.
+    // With limits.multiPv = N every iteration searches the root N times, each time
+    // excluding the moves already reported, so one search yields the N best lines.
+    SearchResult think(const Position& root, const SearchLimits& limits);
+
+    // Ask a running think() to return as soon as possible (thread safe)
+    void stop() { stopRequested_ = true; }
+
+    // Forget everything learned in earlier searches (new game)
+    void clear();
+
+    // Transposition table size in megabytes (the table is cleared)
+    void setHashSize(std::size_t megabytes) { tt_->resize(megabytes); }
+
+    // Called after every completed iteration with the result so far, on the searching
+    // thread (for "info" output). nodes and timeMs are filled in as of that moment.
+    void setIterationCallback(std::function<void(const SearchResult&)> callback) { onIteration_ = std::move(callback); }
+
+    // Parallel search (ParallelSearch): share the given table instead of this search's
+    // own, and as helper number id > 0 skip some iterations so helpers spread over depths
+    void shareTable(TranspositionTable* shared, int helperId);
+
+    // Nodes searched so far by a running think(), updated every 1024 nodes (thread safe)
+    std::uint64_t nodesSearched() const { return publishedNodes_.load(std::memory_order_relaxed); }
+
+private:
+    int negamax(int depth, int alpha, int beta, int ply);
+    int quiescence(int alpha, int beta, int ply);
+    void updateQuietStats(EngineMove best, int depth, int ply, const EngineMove* quiets, int quietCount);
+    bool shouldAbort();
+    int staticEval();
+
+    Position pos_;
+    TimeManager time_;
+    SearchLimits limits_;
+    TranspositionTable ownTt_;
+    TranspositionTable* tt_ = &ownTt_;
+    int helperId_ = 0;
+    std::function<void(const SearchResult&)> onIteration_;
+    std::atomic<std::uint64_t> publishedNodes_{0};
+    HistoryTables history_;
+    PawnTable pawns_;
+    SearchStats stats_;
+    std::atomic<bool> stopRequested_{false};
+    bool aborted_ = false;
+    std::uint64_t nodes_ = 0;
+    int selDepth_ = 0;
+
+    // Triangular principal variation table
+    EngineMove pv_[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength_[MAX_PLY + 1];
+
+    EngineMove killers_[MAX_PLY + 1][2];
+    // Move played at each ply and the piece that made it, for counter moves
+    // (the destination square alone is ambiguous for castling, where it holds the rook)
+    EngineMove moveStack_[MAX_PLY + 1];
+    int movedPiece_[MAX_PLY + 1];
+
+    // Best root move of the iteration in progress (valid even if it gets aborted)
+    EngineMove rootBest_ = NO_MOVE;
+    int rootBestScore_ = 0;
+    EngineMove prevBest_ = NO_MOVE;
+
+    // Root moves already reported in the current multi-PV iteration
+    std::vector<EngineMove> rootExcluded_;
+};
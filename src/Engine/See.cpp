@@ -0,0 +1,83 @@
+#include "See.hpp"
+#include "Evaluate.hpp"
+#include <algorithm>
+
+using namespace Bitboards;
+
+namespace {
+
+// Kings only ever take last, so give them a value nothing can outweigh
+constexpr int SEE_KING_VALUE = 20000;
+
+int seeValue(PieceType t) {
+    return t == PieceType::KING ? SEE_KING_VALUE : pieceValue(t);
+}
+
+} // namespace
+
+int staticExchange(const Position& pos, EngineMove m) {
+    if (moveKind(m) == MoveKind::CASTLING) return 0;
+
+    const int from = moveFrom(m);
+    const int to = moveTo(m);
+    Bitboard occ = pos.pieces() ^ squareBB(from);
+
+    int gain[32];
+    int depth = 0;
+
+    if (moveKind(m) == MoveKind::EN_PASSANT) {
+        gain[0] = pieceValue(PieceType::PAWN);
+        occ ^= squareBB(to + (pos.sideToMove() == Color::WHITE ? 8 : -8));
+    } else {
+        gain[0] = pos.pieceOn(to) == NO_PIECE ? 0 : pieceValue(pieceType(pos.pieceOn(to)));
+    }
+
+    // Value of the piece that now stands on the target square and can be taken next
+    int onSquare = seeValue(pieceType(pos.pieceOn(from)));
+    if (moveKind(m) == MoveKind::PROMOTION) {
+        onSquare = pieceValue(movePromotion(m));
+        gain[0] += onSquare - pieceValue(PieceType::PAWN);
+    }
+
+    const Bitboard diagonal = pos.pieces(PieceType::BISHOP) | pos.pieces(PieceType::QUEEN);
+    const Bitboard straight = pos.pieces(PieceType::ROOK) | pos.pieces(PieceType::QUEEN);
+    Bitboard attackers = pos.attackersTo(to, occ) & occ;
+    Color stm = opposite(pos.sideToMove());
+
+    while (depth < 31) {
+        Bitboard ours = attackers & pos.pieces(stm);
+        if (!ours) break;
+
+        // Least valuable attacker
+        PieceType attacker = PieceType::KING;
+        Bitboard attackerBB = 0;
+        for (PieceType pt : {PieceType::PAWN, PieceType::KNIGHT, PieceType::BISHOP,
+                             PieceType::ROOK, PieceType::QUEEN, PieceType::KING}) {
+            attackerBB = ours & pos.pieces(pt);
+            if (attackerBB) {
+                attacker = pt;
+                break;
+            }
+        }
+
+        // A king cannot capture into a square the opponent still defends
+        if (attacker == PieceType::KING && (attackers & pos.pieces(opposite(stm)))) break;
+
+        ++depth;
+        gain[depth] = onSquare - gain[depth - 1];
+        onSquare = seeValue(attacker);
+
+        // Remove the capturer and uncover any slider behind it
+        occ ^= attackerBB & (~attackerBB + 1);
+        attackers |= (bishopAttacks(to, occ) & diagonal) | (rookAttacks(to, occ) & straight);
+        attackers &= occ;
+        stm = opposite(stm);
+    }
+
+    // Either side may decline to continue the exchange
+    while (depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        --depth;
+    }
+    return gain[0];
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Position.hpp"
+
+// Static exchange evaluation: material balance (centipawns) for the side to
+// move after the full sequence of captures on the move's destination square,
+// with both sides always recapturing with their least valuable attacker and
+// either side free to stop. Sliders hidden behind other attackers (x-rays)
+// join in as the pieces in front of them are exchanged off.
+int staticExchange(const Position& pos, EngineMove m);
+
+// True when the exchange started by m nets at least threshold centipawns
+inline bool seeAtLeast(const Position& pos, EngineMove m, int threshold) {
+    return staticExchange(pos, m) >= threshold;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+// Named bot difficulty levels.
+//
+// Weaker levels cap the nodes searched per move instead of the thinking time,
+// so a level plays the same moves on fast and slow machines, and blur the
+// static evaluation by up to +-evalNoise centipawns. The noise is a hash of
+// the position and a seed (see Search), so a game replayed with the same seed
+// and the same opponent moves is reproduced exactly.
+struct StrengthLevel {
+    const char* name;
+    std::uint64_t nodes;   // node budget per move, 0 = full strength on the clock
+    int evalNoise;         // maximum evaluation error in centipawns
+};
+
+inline constexpr StrengthLevel STRENGTH_LEVELS[] = {
+    {"Beginner", 300, 250},
+    {"Casual", 2000, 120},
+    {"Club", 15000, 50},
+    {"Expert", 120000, 15},
+    {"Master", 0, 0},
+};
+
+constexpr int STRENGTH_LEVEL_COUNT = sizeof(STRENGTH_LEVELS) / sizeof(STRENGTH_LEVELS[0]);
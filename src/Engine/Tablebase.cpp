@@ -0,0 +1,277 @@
+#include "Tablebase.hpp"
+#include "MappedFile.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+
+namespace {
+
+constexpr char PIECE_LETTERS[] = "KQRBNP"; // PieceType order
+constexpr int LETTER_VALUE[6] = {0, 9, 5, 3, 3, 1};
+constexpr int PAWNLESS_KING_SLOTS = 10;
+constexpr int PAWN_KING_SLOTS = 32;
+
+// Symmetries of the board: bit 2 swaps rows and columns, bit 0 mirrors columns, bit 1 rows
+int transform(int sq, int t) {
+    int row = rowOf(sq), col = colOf(sq);
+    if (t & 4) std::swap(row, col);
+    if (t & 1) col = 7 - col;
+    if (t & 2) row = 7 - row;
+    return squareOf(row, col);
+}
+
+// White king slots: the a8-a5-d5 triangle without pawns, files a-d with pawns
+int kingSlot(int sq, bool pawns) {
+    const int row = rowOf(sq), col = colOf(sq);
+    if (pawns) return col <= 3 ? row * 4 + col : -1;
+    return row <= 3 && col <= row ? row * (row + 1) / 2 + col : -1;
+}
+
+int slotSquare(int slot, bool pawns) {
+    if (pawns) return squareOf(slot / 4, slot % 4);
+    int row = 0;
+    while ((row + 1) * (row + 2) / 2 <= slot) ++row;
+    return squareOf(row, slot - row * (row + 1) / 2);
+}
+
+int letterType(char c) {
+    const char* p = std::strchr(PIECE_LETTERS, c);
+    return c && p ? static_cast<int>(p - PIECE_LETTERS) : -1;
+}
+
+struct Table {
+    TbLayout layout;
+    MappedFile file;
+    const std::uint8_t* values = nullptr;
+};
+
+std::map<std::string, std::unique_ptr<Table>> tables;
+int maxLoadedPieces = 0;
+
+} // namespace
+
+TbResult tbDecode(std::uint8_t v) {
+    TbResult r;
+    if (tbIsWin(v)) {
+        r.wdl = 1;
+        r.dtm = v;
+    } else if (tbIsLoss(v)) {
+        r.wdl = -1;
+        r.dtm = v - TB_LOSS_BASE;
+    }
+    return r;
+}
+
+bool TbLayout::init(const std::string& signature) {
+    const std::size_t split = signature.find('v');
+    if (split == std::string::npos || signature[0] != 'K' || split + 1 >= signature.size() ||
+        signature[split + 1] != 'K' || signature.size() - 1 > TB_MAX_PIECES) {
+        return false;
+    }
+
+    signature_ = signature;
+    count_ = 2;
+    pieces_[0] = makePiece(Color::WHITE, PieceType::KING);
+    pieces_[1] = makePiece(Color::BLACK, PieceType::KING);
+    hasPawns_ = false;
+    for (std::size_t i = 1; i < signature.size(); ++i) {
+        if (i == split || i == split + 1) continue;
+        const int type = letterType(signature[i]);
+        if (type <= 0) return false;
+        const Color c = i < split ? Color::WHITE : Color::BLACK;
+        pieces_[count_++] = makePiece(c, static_cast<PieceType>(type));
+        hasPawns_ = hasPawns_ || type == static_cast<int>(PieceType::PAWN);
+    }
+
+    size_ = (hasPawns_ ? PAWN_KING_SLOTS : PAWNLESS_KING_SLOTS) * 64 * 2;
+    for (int i = 2; i < count_; ++i) size_ *= pieceType(pieces_[i]) == PieceType::PAWN ? 48 : 64;
+    return true;
+}
+
+bool TbLayout::index(const int* squares, Color stm, std::uint64_t& idx) const {
+    // First symmetry that brings the white king into its slots
+    int t = 0;
+    while (kingSlot(transform(squares[0], t), hasPawns_) < 0) ++t;
+
+    // A king on the triangle's diagonal is also kept there by reflecting in it:
+    // take the smaller of both indices so that every symmetric copy shares one slot
+    const bool diagonal = !hasPawns_ && rowOf(transform(squares[0], t)) == colOf(transform(squares[0], t));
+    bool found = false;
+    for (int reflect = 0; reflect <= (diagonal ? 1 : 0); ++reflect) {
+        auto place = [&](int sq) {
+            sq = transform(sq, t);
+            return reflect ? squareOf(colOf(sq), rowOf(sq)) : sq;
+        };
+        std::uint64_t i = static_cast<std::uint64_t>(kingSlot(place(squares[0]), hasPawns_));
+        i = i * 64 + place(squares[1]);
+        for (int p = 2; p < count_; ++p) {
+            const int sq = place(squares[p]);
+            if (pieceType(pieces_[p]) == PieceType::PAWN) {
+                if (rowOf(sq) == 0 || rowOf(sq) == 7) return false;
+                i = i * 48 + (sq - 8);
+            } else {
+                i = i * 64 + sq;
+            }
+        }
+        i = i * 2 + static_cast<int>(stm);
+        if (!found || i < idx) idx = i;
+        found = true;
+    }
+    return true;
+}
+
+void TbLayout::decode(std::uint64_t idx, int* squares, Color& stm) const {
+    stm = static_cast<Color>(idx & 1);
+    idx >>= 1;
+    for (int i = count_ - 1; i >= 2; --i) {
+        if (pieceType(pieces_[i]) == PieceType::PAWN) {
+            squares[i] = static_cast<int>(idx % 48) + 8;
+            idx /= 48;
+        } else {
+            squares[i] = static_cast<int>(idx % 64);
+            idx /= 64;
+        }
+    }
+    squares[1] = static_cast<int>(idx % 64);
+    squares[0] = slotSquare(static_cast<int>(idx / 64), hasPawns_);
+}
+
+std::string tbSignature(const int* pieces, int count, bool& swapped) {
+    std::string side[2];
+    int value[2] = {0, 0};
+    // Letters in PieceType order: K Q R B N P
+    for (int type = 0; type < 6; ++type) {
+        for (int i = 0; i < count; ++i) {
+            if (static_cast<int>(pieceType(pieces[i])) != type) continue;
+            const int c = static_cast<int>(pieceColor(pieces[i]));
+            side[c] += PIECE_LETTERS[type];
+            value[c] += LETTER_VALUE[type];
+        }
+    }
+    swapped = value[1] > value[0] || (value[1] == value[0] && side[1] > side[0]);
+    return swapped ? side[1] + "v" + side[0] : side[0] + "v" + side[1];
+}
+
+namespace Tablebase {
+
+bool add(const std::string& path) {
+    auto table = std::make_unique<Table>();
+    if (!table->file.open(path) || table->file.size() < sizeof(TbFileHeader)) return false;
+
+    TbFileHeader header;
+    std::memcpy(&header, table->file.data(), sizeof(header));
+    header.signature[sizeof(header.signature) - 1] = '\0';
+    if (header.magic != TB_MAGIC || header.version != TB_VERSION || !header.complete) return false;
+    if (!table->layout.init(header.signature) || header.size != table->layout.size() ||
+        table->file.size() < sizeof(TbFileHeader) + header.size) {
+        return false;
+    }
+
+    table->values = table->file.data() + sizeof(TbFileHeader);
+    maxLoadedPieces = std::max(maxLoadedPieces, table->layout.pieceCount());
+    tables[table->layout.signature()] = std::move(table);
+    return true;
+}
+
+int init(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    int loaded = 0;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.path().extension() == ".tb" && add(entry.path().string())) ++loaded;
+    }
+    return loaded;
+}
+
+int maxPieces() {
+    return maxLoadedPieces;
+}
+
+bool find(const std::string& signature, const TbLayout*& layout, const std::uint8_t*& values) {
+    auto it = tables.find(signature);
+    if (it == tables.end()) return false;
+    layout = &it->second->layout;
+    values = it->second->values;
+    return true;
+}
+
+bool probe(const int* pieces, const int* squares, int count, Color stm, TbResult& result) {
+    if (count == 2) {
+        result = TbResult{};
+        return true;
+    }
+
+    bool swapped;
+    auto it = tables.find(tbSignature(pieces, count, swapped));
+    if (it == tables.end()) return false;
+    const TbLayout& layout = it->second->layout;
+
+    // Put the pieces into the table's slot order, seen from the table's strong side
+    int slotSquares[TB_MAX_PIECES];
+    bool used[TB_MAX_PIECES] = {};
+    for (int slot = 0; slot < layout.pieceCount(); ++slot) {
+        for (int i = 0; i < count; ++i) {
+            const int pc = swapped ? makePiece(opposite(pieceColor(pieces[i])), pieceType(pieces[i])) : pieces[i];
+            if (!used[i] && pc == layout.piece(slot)) {
+                used[i] = true;
+                slotSquares[slot] = swapped ? flipRow(squares[i]) : squares[i];
+                break;
+            }
+        }
+    }
+
+    std::uint64_t idx;
+    if (!layout.index(slotSquares, swapped ? opposite(stm) : stm, idx)) return false;
+    const std::uint8_t v = it->second->values[idx];
+    if (v == TB_INVALID) return false;
+    result = tbDecode(v);
+    return true;
+}
+
+bool probe(const Position& pos, TbResult& result) {
+    const Bitboard occupied = pos.pieces();
+    const int count = popCount(occupied);
+    if (count > maxLoadedPieces && count > 2) return false;
+    if (pos.castlingRights() || pos.epSquare() != NO_SQUARE) return false;
+
+    int pieces[TB_MAX_PIECES], squares[TB_MAX_PIECES];
+    int n = 0;
+    for (Bitboard b = occupied; b;) {
+        squares[n] = popLsb(b);
+        pieces[n] = pos.pieceOn(squares[n]);
+        ++n;
+    }
+    return probe(pieces, squares, n, pos.sideToMove(), result);
+}
+
+bool bestMove(const Position& pos, EngineMove& move, TbResult& result) {
+    TbResult root;
+    if (!probe(pos, root)) return false;
+
+    MoveList legal;
+    pos.legalMoves(legal);
+    Position child = pos;
+    int bestRank = -1000;
+    move = NO_MOVE;
+    for (EngineMove m : legal) {
+        child.doMove(m);
+        TbResult r;
+        const bool found = probe(child, r);
+        child.undoMove(m);
+        if (!found) return false;
+
+        // Quickest win first, then draws, then the longest resistance
+        const int rank = r.wdl < 0 ? 500 - r.dtm : r.wdl == 0 ? 0 : -500 + r.dtm;
+        if (rank > bestRank) {
+            bestRank = rank;
+            move = m;
+            result.wdl = -r.wdl;
+            result.dtm = r.wdl < 0 ? r.dtm + 1 : r.dtm;
+        }
+    }
+    return move != NO_MOVE;
+}
+
+} // namespace Tablebase
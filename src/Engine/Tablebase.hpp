@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include "Position.hpp"
+
+// Locally generated endgame tablebases (3-5 pieces, no castling or en passant).
+//
+// One file per material signature, e.g. "KRPvKR" (strong side first), holds a
+// byte per position: draw, win in N moves or loss in N moves (distance to
+// mate) for the side to move. Files are written by tools/tb_generator and
+// memory-mapped on load; probing is a few table lookups and is thread safe.
+//
+// Positions are indexed as (white king, black king, other pieces..., side to
+// move) after symmetry reduction: pawnless tables rotate/mirror the board so
+// the white king stands in the a8-a5-d5 triangle (10 squares), tables with
+// pawns only mirror files so it stands on a-d. Pawns use 48 squares, other
+// pieces 64, so a 5-piece pawnless table is 10 * 64^4 * 2 = 335 MB.
+
+constexpr int TB_MAX_PIECES = 5;
+
+// Stored values
+constexpr std::uint8_t TB_DRAW = 0;         // also "unknown" while generating
+constexpr std::uint8_t TB_LOSS_BASE = 128;  // TB_LOSS_BASE + n: mated in n moves (n <= 126)
+constexpr std::uint8_t TB_INVALID = 255;    // illegal placement
+constexpr int TB_MAX_DTM = 126;
+
+inline std::uint8_t tbWin(int moves) { return static_cast<std::uint8_t>(std::min(moves, TB_MAX_DTM + 1)); }
+inline std::uint8_t tbLoss(int moves) { return static_cast<std::uint8_t>(TB_LOSS_BASE + std::min(moves, TB_MAX_DTM)); }
+inline bool tbIsWin(std::uint8_t v) { return v >= 1 && v < TB_LOSS_BASE; }
+inline bool tbIsLoss(std::uint8_t v) { return v >= TB_LOSS_BASE && v != TB_INVALID; }
+
+// Probe result for the side to move
+struct TbResult {
+    int wdl = 0;   // 1 win, 0 draw, -1 loss
+    int dtm = 0;   // moves to mate (winning side's moves), 0 for draws
+};
+
+TbResult tbDecode(std::uint8_t v);
+
+// Index layout of one material signature
+class TbLayout {
+public:
+    // Parse "KQvK", "KRPvKR", ... Returns false for anything but K...vK... with 2-5 pieces.
+    bool init(const std::string& signature);
+
+    const std::string& signature() const { return signature_; }
+    int pieceCount() const { return count_; }
+    int piece(int i) const { return pieces_[i]; }   // [0] white king, [1] black king, then the rest
+    bool hasPawns() const { return hasPawns_; }
+    std::uint64_t size() const { return size_; }
+
+    // Index of a placement (squares in piece order). Applies the symmetry
+    // reduction; returns false for placements that have no slot (pawn on a back rank).
+    bool index(const int* squares, Color stm, std::uint64_t& idx) const;
+    void decode(std::uint64_t idx, int* squares, Color& stm) const;
+
+private:
+    std::string signature_;
+    int count_ = 0;
+    int pieces_[TB_MAX_PIECES] = {};
+    bool hasPawns_ = false;
+    std::uint64_t size_ = 0;
+};
+
+// Canonical signature for the given piece codes (strong side first). swapped is set
+// when Black owns the first half, i.e. the table is stored with colours exchanged.
+std::string tbSignature(const int* pieces, int count, bool& swapped);
+
+namespace Tablebase {
+
+// Map every complete table file (*.tb) in a directory; returns the number loaded
+int init(const std::string& directory);
+
+// Map one table file; false if it is missing, incomplete or malformed
+bool add(const std::string& path);
+
+int maxPieces();
+
+// Probe by piece list (codes as in Position, colours as on the board). K vs K is a draw
+// without a table. Returns false when no table covers the material.
+bool probe(const int* pieces, const int* squares, int count, Color stm, TbResult& result);
+
+// Probe a position; false if it is not covered (too many pieces, castling or en passant rights)
+bool probe(const Position& pos, TbResult& result);
+
+// Layout and values of a loaded table, for the generator's lookups into smaller tables
+bool find(const std::string& signature, const TbLayout*& layout, const std::uint8_t*& values);
+
+// Best move by distance to mate: quickest win, otherwise a draw, otherwise the slowest loss
+bool bestMove(const Position& pos, EngineMove& move, TbResult& result);
+
+} // namespace Tablebase
+
+// On-disk header of a table file, followed by size() value bytes
+struct TbFileHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    char signature[16];
+    std::uint64_t size;
+    std::uint32_t complete;    // 1 once generation finished
+    std::uint32_t iteration;   // generation progress, for resuming
+    std::uint8_t reserved[16];
+};
+
+constexpr std::uint32_t TB_MAGIC = 0x42544843; // "CHTB"
+constexpr std::uint32_t TB_VERSION = 1;
@@ -0,0 +1,69 @@
+#include "TimeManager.hpp"
+#include <algorithm>
+
+void TimeManager::init(const SearchLimits& limits, int gamePly) {
+    start_ = std::chrono::steady_clock::now();
+    timed_ = false;
+    fixedMoveTime_ = false;
+    lastIterationMs_ = 0;
+    instability_ = 0.0;
+    lastScore_ = 0;
+    iterations_ = 0;
+
+    if (limits.moveTimeMs > 0) {
+        timed_ = true;
+        fixedMoveTime_ = true;
+        softMs_ = hardMs_ = std::max<std::int64_t>(1, limits.moveTimeMs - MOVE_OVERHEAD_MS);
+        return;
+    }
+    if (limits.timeLeftMs < 0) return;
+
+    timed_ = true;
+    const std::int64_t time = std::max<std::int64_t>(1, limits.timeLeftMs - MOVE_OVERHEAD_MS);
+    const std::int64_t inc = limits.incrementMs;
+
+    // Expect fewer remaining moves as the game goes on, but always plan for at least 20
+    const int moveNumber = gamePly / 2 + 1;
+    const int movesLeft = limits.movesToGo > 0 ? std::min(limits.movesToGo, 50)
+                                               : std::max(20, 45 - moveNumber / 2);
+
+    // Never burn more than 80% of what is left on a single move
+    const std::int64_t maxBudget = std::max<std::int64_t>(1, time * 4 / 5);
+
+    softMs_ = std::max<std::int64_t>(1, std::min(time / movesLeft + inc * 3 / 4, maxBudget));
+    hardMs_ = std::min(std::max(softMs_, std::min(softMs_ * 4, time / 5)), maxBudget);
+}
+
+std::int64_t TimeManager::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+}
+
+bool TimeManager::continueIterating(std::int64_t iterationMs, bool bestMoveChanged, int score) {
+    if (!timed_) return true;
+
+    const std::int64_t elapsed = elapsedMs();
+
+    // Recent best-move changes count more than old ones
+    instability_ = instability_ * 0.5 + (bestMoveChanged ? 1.0 : 0.0);
+    double factor = 0.7 + 0.8 * instability_;
+    if (iterations_ > 0 && score < lastScore_ - 30) factor *= 1.25; // score is dropping, look deeper
+    if (fixedMoveTime_) factor = 1.0;
+
+    // Estimate the next iteration from the growth between the last two
+    double branching = 3.0;
+    if (lastIterationMs_ > 0 && iterationMs > 0) {
+        branching = std::clamp(static_cast<double>(iterationMs) / lastIterationMs_, 1.5, 6.0);
+    }
+    const std::int64_t predicted = static_cast<std::int64_t>(iterationMs * branching);
+
+    lastIterationMs_ = iterationMs;
+    lastScore_ = score;
+    ++iterations_;
+
+    const std::int64_t budget = std::min(static_cast<std::int64_t>(softMs_ * factor), hardMs_);
+    if (elapsed >= budget) return false;
+
+    // Do not start an iteration that would be cut off by the hard limit anyway
+    return elapsed + predicted <= std::min(hardMs_, 2 * budget);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "Position.hpp"
+
+// Limits for one search. Fields left at their defaults are unbounded.
+struct SearchLimits {
+    std::int64_t timeLeftMs = -1;   // remaining clock of the side to move, -1 = no clock
+    std::int64_t incrementMs = 0;   // per-move increment
+    int movesToGo = 0;              // moves until the next time control, 0 = sudden death
+    std::int64_t moveTimeMs = 0;    // fixed time for this move, 0 = use the clock
+    int depth = 0;                  // maximum iterative-deepening depth, 0 = unlimited
+    std::uint64_t nodes = 0;        // node budget, 0 = unlimited
+    int multiPv = 1;                // number of best root moves to report in SearchResult::lines
+    std::vector<EngineMove> searchMoves; // root moves to choose from (UCI searchmoves), empty = all
+    int evalNoise = 0;              // +- centipawns of seeded evaluation noise (strength levels)
+    std::uint64_t noiseSeed = 0;
+
+    // Selective search, each switchable for A/B matches (tools/match_runner)
+    bool nullMove = true;           // null-move pruning
+    bool lateMoveReductions = true;
+    bool futility = true;           // futility and reverse futility pruning near the leaves
+    bool razoring = true;
+};
+
+// Splits the remaining clock into a soft budget (normal target for one move)
+// and a hard limit (search is aborted when it is reached). Between iterations
+// the search asks continueIterating(), which stretches the soft budget while
+// the best move keeps changing and refuses to start an iteration that is not
+// expected to finish.
+class TimeManager {
+public:
+    // Safety margin for GUI latency and applying the move on the board
+    static constexpr std::int64_t MOVE_OVERHEAD_MS = 50;
+
+    void init(const SearchLimits& limits, int gamePly);
+
+    std::int64_t elapsedMs() const;
+    std::int64_t softLimitMs() const { return softMs_; }
+    std::int64_t hardLimitMs() const { return hardMs_; }
+    bool isTimed() const { return timed_; }
+
+    // Polled from inside the search
+    bool hardLimitReached() const { return timed_ && elapsedMs() >= hardMs_; }
+
+    // Called after every completed iteration; returns false when the next one should not start
+    bool continueIterating(std::int64_t iterationMs, bool bestMoveChanged, int score);
+
+private:
+    std::chrono::steady_clock::time_point start_;
+    bool timed_ = false;
+    bool fixedMoveTime_ = false;
+    std::int64_t softMs_ = 0;
+    std::int64_t hardMs_ = 0;
+    std::int64_t lastIterationMs_ = 0;
+    double instability_ = 0.0;
+    int lastScore_ = 0;
+    int iterations_ = 0;
+};
@@ -0,0 +1,94 @@
+#include "TranspositionTable.hpp"
+#include "Search.hpp"
+#include <algorithm>
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    resize(megabytes);
+}
+
+namespace {
+
+// Packed entry: move in bits 0-15, score 16-31, depth 32-39, bound 40-47, generation 48-55
+std::uint64_t pack(EngineMove move, int score, int depth, Bound bound, std::uint8_t generation) {
+    return static_cast<std::uint64_t>(move) | static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16 |
+           static_cast<std::uint64_t>(depth) << 32 | static_cast<std::uint64_t>(bound) << 40 |
+           static_cast<std::uint64_t>(generation) << 48;
+}
+
+TTEntry unpack(std::uint64_t key, std::uint64_t data) {
+    TTEntry e;
+    e.key = key;
+    e.move = static_cast<EngineMove>(data & 0xFFFF);
+    e.score = static_cast<std::int16_t>((data >> 16) & 0xFFFF);
+    e.depth = static_cast<std::uint8_t>(data >> 32);
+    e.bound = static_cast<Bound>((data >> 40) & 0xFF);
+    e.generation = static_cast<std::uint8_t>(data >> 48);
+    return e;
+}
+
+} // namespace
+
+void TranspositionTable::resize(std::size_t megabytes) {
+    std::size_t entries = std::max<std::size_t>(1, megabytes) * 1024 * 1024 / sizeof(Slot);
+    std::size_t size = 1;
+    while (size * 2 <= entries) size *= 2;
+    table_ = std::make_unique<Slot[]>(size);
+    size_ = size;
+    mask_ = size - 1;
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < size_; ++i) {
+        table_[i].keyXorData.store(0, std::memory_order_relaxed);
+        table_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TTEntry& out) const {
+    const Slot& slot = table_[key & mask_];
+    const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) != key) return false;
+    out = unpack(key, data);
+    return out.bound != Bound::NONE;
+}
+
+void TranspositionTable::store(std::uint64_t key, EngineMove move, int score, int depth, Bound bound) {
+    Slot& slot = table_[key & mask_];
+    const std::uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    const std::uint64_t oldKey = slot.keyXorData.load(std::memory_order_relaxed) ^ oldData;
+    const TTEntry e = unpack(oldKey, oldData);
+
+    // Keep a deeper result for the same position from this search unless the new one is exact
+    if (e.key == key && e.generation == generation_ && depth + 2 < e.depth && bound != Bound::EXACT) return;
+    // Prefer keeping deep entries of other positions from the current search
+    if (e.key != key && e.generation == generation_ && depth + 4 < e.depth) return;
+
+    // Do not lose a known best move when this search found none
+    if (move == NO_MOVE && e.key == key) move = e.move;
+
+    const std::uint64_t data = pack(move, score, std::clamp(depth, 0, 255), bound, generation_);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    const std::size_t sample = std::min<std::size_t>(1000, size_);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        const TTEntry e = unpack(0, table_[i].data.load(std::memory_order_relaxed));
+        if (e.bound != Bound::NONE && e.generation == generation_) ++used;
+    }
+    return static_cast<int>(used * 1000 / sample);
+}
+
+int scoreToTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+int scoreFromTT(int score, int ply) {
+    if (score >= VALUE_MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -VALUE_MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
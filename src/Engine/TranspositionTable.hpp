@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Position.hpp"
+
+enum class Bound : std::uint8_t { NONE, UPPER, LOWER, EXACT };
+
+struct TTEntry {
+    std::uint64_t key = 0;
+    EngineMove move = NO_MOVE;
+    std::int16_t score = 0;
+    std::uint8_t depth = 0;
+    Bound bound = Bound::NONE;
+    std::uint8_t generation = 0;
+};
+
+// Hash table of previously searched positions, shared by all iterations and
+// moves of a game, and by the threads of a parallel search. Size is rounded
+// down to a power of two entries.
+//
+// Slots are two 64-bit words, the packed entry and the key xor-ed with it, so
+// threads read and write without locks: a slot torn by a concurrent write no
+// longer matches its key and reads as a miss.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(std::size_t megabytes = 16);
+
+    void resize(std::size_t megabytes);
+    void clear();
+
+    // Start of a new search: older entries become preferred replacement victims
+    void newSearch() { ++generation_; }
+
+    bool probe(std::uint64_t key, TTEntry& out) const;
+    void store(std::uint64_t key, EngineMove move, int score, int depth, Bound bound);
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> keyXorData{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> table_;
+    std::size_t size_ = 0;
+    std::size_t mask_ = 0;
+    std::uint8_t generation_ = 0;
+};
+
+// Mate scores are stored relative to the node so they stay valid at any ply
+int scoreToTT(int score, int ply);
+int scoreFromTT(int score, int ply);
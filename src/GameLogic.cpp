@@ -22,6 +22,9 @@ void GameLogic::setup() {
         }
     }
 
+    isChess960 = false;
+    isDiagonal = false;
+
     // Setup Black Pieces (Rows 0, 1)
     grid[0][0] = std::make_unique<Rook>(Color::BLACK);
     grid[0][1] = std::make_unique<Knight>(Color::BLACK);
@@ -58,6 +61,9 @@ void GameLogic::setupDiagonal() {
             grid[i][j] = nullptr;
         }
     }
+
+    isChess960 = false;
+    isDiagonal = true;
     
     grid[0][7] = std::make_unique<King>(Color::BLACK);
     grid[0][6] = std::make_unique<Bishop>(Color::BLACK);
@@ -101,6 +107,7 @@ void GameLogic::setupFischer() {
     }
 
     isChess960 = true;
+    isDiagonal = false;
 
     // Setup Pawns (same as standard chess)
     for (int i = 0; i < 8; i++) {
@@ -91,6 +91,9 @@ public:
     // Check if this is a Chess960 game
     bool isChess960Game() const { return isChess960; }
 
+    // Check if this is a Diagonal Chess game
+    bool isDiagonalGame() const { return isDiagonal; }
+
 private:
     Grid grid;
     Color turn;
@@ -103,8 +106,9 @@ private:
     bool stalemate = false;
     Color winner = Color::NONE;
 
-    // Chess960 flag
+    // Variant flags
     bool isChess960 = false;
+    bool isDiagonal = false;
 
     // Sound callback
     SoundCallback soundCallback;
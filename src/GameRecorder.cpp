@@ -160,6 +160,11 @@ void GameRecorder::saveToFile() {
         throw std::runtime_error("Cannot open file: " + filepath.string());
     }
 
+    // Chess960 starts are shuffled: keep the position so the game can be replayed
+    if (variant == "fischer" && !startFen.empty()) {
+        file << "FEN: " << startFen << "\n\n";
+    }
+
     // Write moves in format: 1. e4 e5
     int moveNumber = 1;
     for (size_t i = 0; i < moves.size(); i++) {
@@ -237,6 +242,9 @@ void GameRecorder::saveToFile() {
     file.close();
 
     std::cout << "Game saved to: " << filepath.string() << std::endl;
+
+    savedPath = filepath.string();
+    if (saveCallback) saveCallback(*this);
 }
 
 void GameRecorder::clear() {
@@ -244,4 +252,6 @@ void GameRecorder::clear() {
     gameResult = GameResult::UNKNOWN;
     endReason = "unknown";
     filename = "";
+    startFen = "";
+    savedPath = "";
 }
\ No newline at end of file
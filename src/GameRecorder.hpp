@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <functional>
 #include "GameLogic.hpp"
 
 // Game result types
@@ -32,6 +33,8 @@ private:
     GameResult gameResult;
     std::string endReason; // "checkmate", "timeout", "stalemate", etc.
     std::string variant; // game variant / subdirectory under recent_games
+    std::string startFen; // position before the first move, empty if unknown
+    std::string savedPath; // full path of the last saved file
     
     // Helper methods
     std::string getCurrentDateTime();
@@ -51,6 +54,10 @@ public:
     // Set/get game variant (e.g. "standard", "fischer", "diagonal", "cylinder")
     void setVariant(const std::string& v) { variant = v; }
     std::string getVariant() const { return variant; }
+
+    // Starting position as FEN (X-FEN for Chess960), kept with the moves for post-game analysis
+    void setStartFen(const std::string& fen) { startFen = fen; }
+    std::string getStartFen() const { return startFen; }
     
     // Record a move with game state information
     void recordMove(const Move& move, PieceType movingPiece, bool isCheckmate, bool isCheck, bool isCapture);
@@ -69,5 +76,16 @@ public:
     
     // Get the filename that will be used for saving
     std::string getFilename() const { return filename; }
+
+    // Recorded moves and the full path of the last saved file
+    const std::vector<RecordedMove>& getMoves() const { return moves; }
+    std::string getSavedPath() const { return savedPath; }
+
+    // Called after every successful save (e.g. to start a post-game analysis)
+    using SaveCallback = std::function<void(const GameRecorder& recorder)>;
+    void setSaveCallback(SaveCallback callback) { saveCallback = callback; }
+
+private:
+    SaveCallback saveCallback;
 };
 
@@ -1,8 +1,19 @@
 #include "bot.hpp"
+#include "Engine/See.hpp"
+#include "Engine/Tablebase.hpp"
 
 #include <vector>
 #include <random>
 #include <cmath>
+#include <iostream>
+#include <thread>
+
+// Shallower results are neither stored in nor played from the learning table
+static constexpr int LEARN_MIN_DEPTH = 10;
+
+// A playout costs about as much time as this many alpha-beta nodes, so limited
+// strength levels get comparable budgets with either engine
+static constexpr std::uint64_t MCTS_PLAYOUT_COST = 10;
 
 static int pieceValue(PieceType t)
 {
@@ -17,7 +28,10 @@ static int pieceValue(PieceType t)
     }
 }
 
-Bot::Bot(Color botColor) : color_(botColor) {}
+static int allCores() { return static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); }
+
+Bot::Bot(Color botColor)
+    : color_(botColor), mcts_(allCores()), bookRng_(std::random_device{}()) {}
 
 std::optional<Move> Bot::pickMove(const GameLogic& game) const
 {
@@ -26,6 +40,10 @@ std::optional<Move> Bot::pickMove(const GameLogic& game) const
     GameLogic& g = const_cast<GameLogic&>(game);
     const Color enemy = (color_ == Color::WHITE) ? Color::BLACK : Color::WHITE;
 
+    // Bitboard copy of the board for exchange evaluation of captures
+    Position pos;
+    pos.setFromGame(game);
+
     std::vector<Move> bestGoodCaptures, bestBadCaptures, safeQuietMoves, riskyQuietMoves, bestThreatEscapes;
     int bestGoodCaptureScore = -1;
     int bestBadCaptureScore  = -1;
@@ -37,8 +55,6 @@ std::optional<Move> Bot::pickMove(const GameLogic& game) const
             const Piece* piece = g.getPiece(r1, c1);
             if (!piece || piece->color != color_) continue;
 
-            const int attackerVal = pieceValue(piece->type);
-
             const bool threatenedNonPawn =
                 piece->type != PieceType::PAWN &&
                 g.isSquareAttacked(r1, c1, enemy);
@@ -92,10 +108,11 @@ std::optional<Move> Bot::pickMove(const GameLogic& game) const
 
                     // bicie
                     if (isCapture) {
-                        bool badTrade = false;
-                        if (capturedVal < attackerVal && g.isSquareAttacked(r2, c2, enemy)) {
-                            badTrade = true;
-                        }
+                        // zła wymiana: cała sekwencja bić na polu docelowym traci materiał
+                        const int from = squareOf(r1, c1);
+                        const int to = squareOf(r2, c2);
+                        const bool badTrade = staticExchange(pos, encodeMove(from, to,
+                            m.isEnPassant ? MoveKind::EN_PASSANT : MoveKind::NORMAL)) < 0;
 
                         if (!badTrade) {
                             if (capturedVal > bestGoodCaptureScore) {
@@ -160,3 +177,133 @@ std::optional<Move> Bot::pickMove(const GameLogic& game) const
 
     return std::nullopt;
 }
+
+bool Bot::setOpeningBook(const std::string& path)
+{
+    return book_.open(path);
+}
+
+bool Bot::setLearningTable(const std::string& path)
+{
+    return learning_.open(path);
+}
+
+SearchResult Bot::analyze(const Position& pos, SearchLimits limits, int lines)
+{
+    limits.multiPv = lines;
+    return search_.think(pos, limits);
+}
+
+void Bot::setStrength(const StrengthLevel& level, std::uint64_t seed)
+{
+    strength_ = level;
+    seed_ = seed;
+    bookRng_.seed(seed);
+    search_.clear();
+    mcts_.clear();
+    // Playouts from several threads with virtual loss depend on scheduling; a playout
+    // budget played on one thread gives the same tree on every machine and every run
+    mcts_.setThreads(level.nodes ? 1 : allCores());
+}
+
+bool Bot::setStatsLog(const std::string& path)
+{
+    statsLog_.open(path, std::ios::app);
+    return statsLog_.is_open();
+}
+
+std::optional<Move> Bot::searchMove(const Position& pos, const SearchLimits& clockLimits)
+{
+    if (pos.sideToMove() != color_) return std::nullopt;
+
+    report_ = BotMoveReport{};
+    const EngineMove move = chooseMove(pos, clockLimits);
+    if (move == NO_MOVE) return std::nullopt;
+    report_.move = pos.toUci(move);
+    if (statsLog_.is_open()) logReport(pos);
+    return pos.toGameMove(move);
+}
+
+// One JSON line per move; search fields are zero for book, tablebase and learned moves
+void Bot::logReport(const Position& pos)
+{
+    const SearchResult& r = report_.search;
+    statsLog_ << "{\"ply\":" << pos.gamePly() << ",\"fen\":\"" << pos.toFen() << "\""
+              << ",\"source\":\"" << report_.source << "\",\"move\":\"" << report_.move << "\""
+              << ",\"score\":" << r.score << ",\"depth\":" << r.depth << ",\"seldepth\":" << r.selDepth
+              << ",\"nodes\":" << r.nodes << ",\"nps\":" << r.nodesPerSecond()
+              << ",\"ebf\":" << r.stats.effectiveBranching() << ",\"tt_hit_rate\":" << r.stats.ttHitRate()
+              << ",\"time_ms\":" << r.timeMs << "}" << std::endl;
+}
+
+EngineMove Bot::chooseMove(const Position& pos, const SearchLimits& clockLimits)
+{
+    // Book moves are instant; the book is the one of the game's variant
+    EngineMove bookMove = book_.pick(pos, bookRng_);
+    if (bookMove != NO_MOVE) {
+        std::cout << "Bot: book move " << pos.toUci(bookMove) << "\n";
+        report_.source = "book";
+        return bookMove;
+    }
+
+    // Solved endgames need no search: quickest mate, or the longest resistance
+    EngineMove tbMove;
+    TbResult tb;
+    if (Tablebase::bestMove(pos, tbMove, tb)) {
+        std::cout << "Bot: tablebase move " << pos.toUci(tbMove)
+                  << (tb.wdl > 0 ? ", mates in " : tb.wdl < 0 ? ", mated in " : ", draw")
+                  << (tb.wdl != 0 ? std::to_string(tb.dtm) : "") << "\n";
+        report_.source = "tablebase";
+        return tbMove;
+    }
+
+    // Positions searched deeply in earlier sessions; weaker levels must not play them
+    const bool fullStrength = strength_.nodes == 0 && strength_.evalNoise == 0 && !pos.isChess960() &&
+                              engine_ == BotEngine::ALPHA_BETA;
+    LearnEntry learned;
+    if (fullStrength && learning_.probe(pos, learned) && learned.depth >= LEARN_MIN_DEPTH) {
+        std::cout << "Bot: learned move " << pos.toUci(learned.move) << ", depth " << int(learned.depth)
+                  << ", score " << learned.score << "\n";
+        report_.source = "learned";
+        report_.search.score = learned.score;
+        report_.search.depth = learned.depth;
+        return learned.move;
+    }
+
+    // Limited levels search a fixed number of nodes whatever the clock says
+    SearchLimits limits = clockLimits;
+    if (strength_.nodes) {
+        limits = SearchLimits{};
+        limits.nodes = strength_.nodes;
+    }
+    limits.evalNoise = strength_.evalNoise;
+    limits.noiseSeed = seed_;
+
+    if (engine_ == BotEngine::MCTS) {
+        // No evaluation noise here: weaker levels only get fewer playouts
+        if (limits.nodes) limits.nodes = std::max<std::uint64_t>(limits.nodes / MCTS_PLAYOUT_COST, 1);
+        SearchResult result = mcts_.think(pos, limits);
+        std::cout << "Bot (MCTS): " << result.nodes << " playouts, " << result.timeMs << " ms, win rate score "
+                  << result.score << ", line " << result.depth << " plies\n";
+        report_.source = "mcts";
+        report_.search = std::move(result);
+        return report_.search.bestMove;
+    }
+
+    SearchResult result = search_.think(pos, limits);
+    if (result.bestMove == NO_MOVE) return NO_MOVE;
+    if (fullStrength && result.depth >= LEARN_MIN_DEPTH)
+        learning_.store(pos, result.bestMove, result.score, result.depth);
+
+    std::cout << "Bot: depth " << result.depth << "/" << result.selDepth << ", score " << result.score
+              << ", nodes " << result.nodes << ", " << result.timeMs << " ms"
+              << ", first-move cutoffs " << static_cast<int>(result.stats.firstMoveCutoffRate() * 100) << "%"
+              << ", TT hits " << static_cast<int>(result.stats.ttHitRate() * 100) << "%"
+              << ", pawn hash hits " << static_cast<int>(result.stats.pawnHitRate() * 100) << "%"
+              << ", tablebase hits " << result.stats.tbHits
+              << ", null-move cutoffs " << result.stats.nullCutoffs
+              << ", LMR " << result.stats.lmrReductions << " (" << result.stats.lmrReSearches << " re-searched)\n";
+    report_.source = "search";
+    report_.search = std::move(result);
+    return report_.search.bestMove;
+}
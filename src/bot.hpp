@@ -1,15 +1,88 @@
 #pragma once
 
 #include "GameLogic.hpp"
+#include "Engine/Search.hpp"
+#include "Engine/OpeningBook.hpp"
+#include "Engine/LearningTable.hpp"
+#include "Engine/MctsSearch.hpp"
+#include "Engine/Strength.hpp"
+#include <fstream>
 #include <optional>
+#include <random>
+#include <string>
+
+// Search used by searchMove()
+enum class BotEngine {
+    ALPHA_BETA,
+    MCTS
+};
+
+// How the bot found its last move, for the stats panel and the stats log
+struct BotMoveReport {
+    std::string source;     // "book", "tablebase", "learned", "search" or "mcts"
+    std::string move;       // UCI
+    SearchResult search;    // filled for "search" and "mcts"
+};
 
 class Bot {
 public:
     explicit Bot(Color botColor);
 
+    Color getColor() const { return color_; }
+
+    // One-ply heuristic picker: captures, escapes of threatened pieces, random quiet moves
     std::optional<Move> pickMove(const GameLogic& game) const;
 
+    // Iterative-deepening search on a position snapshot within the given clock limits.
+    // Blocks until a move is chosen, so it can be run on a worker thread.
+    std::optional<Move> searchMove(const Position& pos, const SearchLimits& limits);
+
+    // The best `lines` root moves with scores, depths and principal variations, from a
+    // single multi-PV search (hints, post-game review, puzzle generation)
+    SearchResult analyze(const Position& pos, SearchLimits limits, int lines);
+
+    // Make a running searchMove() or analyze() return its best result so far
+    void stop() {
+        search_.stop();
+        mcts_.stop();
+    }
+
+    // Alpha-beta (default) or Monte Carlo tree search (on all cores at full strength,
+    // on one thread at limited levels); book and tablebase moves are played either way
+    void setEngine(BotEngine engine) { engine_ = engine; }
+    BotEngine getEngine() const { return engine_; }
+
+    // Play at a named strength level (Strength.hpp). The seed fixes the evaluation noise
+    // and the book choices, so the same seed and opponent moves replay the same game.
+    void setStrength(const StrengthLevel& level, std::uint64_t seed);
+
+    // Report on the move returned by the last searchMove()
+    const BotMoveReport& lastReport() const { return report_; }
+
+    // Append a JSON object per bot move (JSON lines) with the numbers of lastReport()
+    bool setStatsLog(const std::string& path);
+
+    // Polyglot book consulted by searchMove() before searching; false if the file cannot be
+    // used, and the bot then plays without a book
+    bool setOpeningBook(const std::string& path);
+
+    // File of deep search results kept across sessions (LearningTable.hpp), created if
+    // missing. At full strength, positions found there are answered without searching.
+    bool setLearningTable(const std::string& path);
+
 private:
+    EngineMove chooseMove(const Position& pos, const SearchLimits& clockLimits);
+    void logReport(const Position& pos);
+
     Color color_;
+    Search search_;
+    MctsSearch mcts_;
+    BotEngine engine_ = BotEngine::ALPHA_BETA;
+    OpeningBook book_;
+    LearningTable learning_;
+    std::mt19937_64 bookRng_;
+    StrengthLevel strength_ = STRENGTH_LEVELS[STRENGTH_LEVEL_COUNT - 1];
+    std::uint64_t seed_ = 0;
+    BotMoveReport report_;
+    std::ofstream statsLog_;
 };
-
@@ -7,11 +7,34 @@
 #include "GameRecorder.hpp"
 #include "SoundManager.hpp"
 #include "bot.hpp"
+#include "Engine/AttackMap.hpp"
+#include "Engine/GameArchive.hpp"
+#include "Engine/GameAnalyzer.hpp"
+#include "Engine/LiveAnalyzer.hpp"
+#include "Engine/Nnue.hpp"
+#include "Engine/Tablebase.hpp"
 #include <memory>
 #include <iostream>
 #include <vector>
 #include <iomanip>
 #include <sstream>
+#include <future>
+#include <chrono>
+#include <cstdlib>
+
+// Polyglot opening books of the bot, <variant>.bin as written by book_builder; without
+// one the bot searches from move one
+static const std::string BOT_BOOK_DIR = "../assets/books/";
+
+// Search results the bot keeps between sessions, next to the executable
+static const char* const BOT_LEARNING_PATH = "bot_learning.bin";
+
+// Environment variable naming a file that receives one JSON line of search numbers per bot move
+static const char* const BOT_STATS_ENV = "CHESS_BOT_STATS";
+
+// Seed of the bot's evaluation noise and book choices: the same level, seed and
+// moves from the player replay the same game
+static const std::uint64_t BOT_SEED = 1;
 
 // Format seconds as MM:SS for the side clocks
 static std::string formatClockTime(double seconds) {
@@ -26,6 +49,16 @@ static std::string formatClockTime(double seconds) {
     return oss.str();
 }
 
+// Compact counts for the stats panel: 950, 81.2k, 1.53M
+static std::string formatCount(std::uint64_t n) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(n >= 1000000 ? 2 : 1);
+    if (n >= 1000000) oss << n / 1e6 << "M";
+    else if (n >= 1000) oss << n / 1e3 << "k";
+    else oss << n;
+    return oss.str();
+}
+
 enum class GameState {
     MENU,
     PLAYING
@@ -76,19 +109,43 @@ int main() {
         {"Rapid 15min", 900.0}
     };
     int selectedTimeControl = 2; // Default: Blitz 5min
+    int selectedStrength = STRENGTH_LEVEL_COUNT - 1; // Default: full strength
+    BotEngine selectedEngine = BotEngine::ALPHA_BETA;
     
     // Dynamic tile size — will scale based on window size
     float tileSize = 60.f;
     Board board(tileSize);
     GameLogic game;
 
+    // Reviews every saved game in the background and writes <game>_analysis.txt next to it
+    GameAnalyzer gameAnalyzer;
+
     // Game recorder for saving moves to file
     GameRecorder gameRecorder;
     game.setGameRecorder(&gameRecorder);
+    gameRecorder.setSaveCallback([&gameAnalyzer](const GameRecorder& recorder) {
+        AnalysisJob job;
+        job.startFen = recorder.getStartFen();
+        job.variant = archivedVariant(recorder.getVariant());
+        for (const RecordedMove& rm : recorder.getMoves()) job.moves.push_back(rm.move);
+        job.gamePath = recorder.getSavedPath();
+        gameAnalyzer.submit(std::move(job));
+    });
 
     // Sound manager
     SoundManager soundManager;
     soundManager.loadSounds("../assets/sounds");
+
+    // Neural evaluation for the bot (trained with tools/nnue_trainer); without it the bot
+    // uses the classical piece-square evaluation
+    if (Nnue::load("../assets/nnue/network.bin")) {
+        std::cout << "Loaded neural network evaluation\n";
+    }
+
+    // Endgame tablebases built with tools/tb_generator; used by the bot's search when present
+    if (int tables = Tablebase::init("../assets/tablebases")) {
+        std::cout << "Loaded " << tables << " endgame tablebases (up to " << Tablebase::maxPieces() << " pieces)\n";
+    }
     
     // Setup sound callback for game logic
     game.setSoundCallback([&soundManager](bool isPawnMove, bool isCapture) {
@@ -203,6 +260,29 @@ int main() {
 
         OpponentMode opponentMode = OpponentMode::HUMAN;
         Bot bot(Color::BLACK); // bot gra czarnymi
+        if (bot.setLearningTable(BOT_LEARNING_PATH)) {
+            std::cout << "Bot learning table: " << BOT_LEARNING_PATH << "\n";
+        }
+        if (const char* statsPath = std::getenv(BOT_STATS_ENV)) {
+            if (bot.setStatsLog(statsPath)) std::cout << "Bot search stats: " << statsPath << "\n";
+        }
+        std::future<std::optional<Move>> botThinking; // search running on a worker thread
+        std::optional<BotMoveReport> lastBotReport;   // shown in the history panel
+
+        // Live analysis of human games (A key): evaluation bar and best-move arrow
+        LiveAnalyzer liveAnalyzer;
+        bool liveAnalysisEnabled = false;
+        std::uint64_t liveKey = 0;                    // position handed to the analyzer, 0 = idle
+        std::optional<LiveEvaluation> liveEval;
+        std::string liveBestSan;
+        std::optional<Move> liveArrow;                // engine arrow currently on the board
+        const sf::Color liveArrowColor(70, 150, 255, 190);
+
+        // Threat map (T key): attackers per square kept up to date move by move
+        bool threatMapEnabled = false;
+        bool threatMapValid = false;                  // threatMap describes threatPosition
+        AttackMap threatMap;
+        Position threatPosition;
 
         sf::Text playHumanText(font, "GRA Z CZLOWIEKIEM", 28);
         playHumanText.setPosition({100.f, 300.f});
@@ -298,6 +378,7 @@ int main() {
                     float buttonWidth = 300.f;
                     float buttonHeight = 50.f;
                     float spacing = 60.f;
+                    float strengthButtonWidth = 180.f;
                     
                     // Check time control buttons
                     for (size_t i = 0; i < timeControls.size(); ++i) {
@@ -307,6 +388,23 @@ int main() {
                             selectedTimeControl = i;
                         }
                     }
+
+                    // Check bot strength buttons (column right of the time controls)
+                    float strengthX = menuX + buttonWidth + 30.f;
+                    for (int i = 0; i < STRENGTH_LEVEL_COUNT; ++i) {
+                        float btnY = menuY + i * spacing;
+                        if (mx >= strengthX && mx <= strengthX + strengthButtonWidth &&
+                            my >= btnY && my <= btnY + buttonHeight) {
+                            selectedStrength = i;
+                        }
+                    }
+
+                    // Engine toggle below the strength column
+                    float engineBtnY = menuY + STRENGTH_LEVEL_COUNT * spacing + 30.f;
+                    if (mx >= strengthX && mx <= strengthX + strengthButtonWidth &&
+                        my >= engineBtnY && my <= engineBtnY + buttonHeight) {
+                        selectedEngine = selectedEngine == BotEngine::ALPHA_BETA ? BotEngine::MCTS : BotEngine::ALPHA_BETA;
+                    }
                     
                     // Check START button
                     float startBtnY = menuY + timeControls.size() * spacing + 30.f;
@@ -322,6 +420,7 @@ int main() {
                         endSoundPlayed = false;
                         gameStarted = false;
                         moveHistory.clear();
+                        lastBotReport.reset();
                         gameRecorder.clear();
                         board.clearMarkedSquares();
                         board.clearArrows();
@@ -329,24 +428,23 @@ int main() {
                         soundManager.playBackgroundMusic(); // Start background music
                         
                         // Setup game with selected mode
-                       if (opponentMode == OpponentMode::BOT) {
-                        // BOT: zawsze standard
-                        chessMode = ChessMode::STANDARD; // opcjonalnie, żeby UI też było spójne
-                        game.setup();
-                        std::cout << "Game started: Standard Chess (vs BOT)\n";
-                         } else {
-                        // HUMAN: Twoja dotychczasowa logika wariantów
                         if (chessMode == ChessMode::FISCHER_RANDOM) {
                             game.setupFischer();
-                            std::cout << "Game started: CHESS960 (Fischer Random)\n";
+                            std::cout << "Game started: CHESS960 (Fischer Random)";
                         } else if (chessMode == ChessMode::DIAGONAL_CHESS) {
                             game.setupDiagonal();
-                            std::cout << "Game started: Diagonal Chess\n";
+                            std::cout << "Game started: Diagonal Chess";
                         } else {
                             game.setup();
-                            std::cout << "Game started: Standard Chess\n";
+                            std::cout << "Game started: Standard Chess";
                         }
-                    }
+                        if (opponentMode == OpponentMode::BOT) {
+                            bot.setStrength(STRENGTH_LEVELS[selectedStrength], BOT_SEED);
+                            bot.setEngine(selectedEngine);
+                            std::cout << " (vs BOT, " << STRENGTH_LEVELS[selectedStrength].name
+                                      << (selectedEngine == BotEngine::MCTS ? ", MCTS" : "") << ")";
+                        }
+                        std::cout << "\n";
 
                         // Set recorder variant so saved files go to subfolders like recent_games/standard
                         switch (chessMode) {
@@ -364,6 +462,15 @@ int main() {
                                 break;
                         }
 
+                        if (opponentMode == OpponentMode::BOT) {
+                            const std::string bookPath = BOT_BOOK_DIR + gameRecorder.getVariant() + ".bin";
+                            if (bot.setOpeningBook(bookPath)) std::cout << "Bot opening book: " << bookPath << "\n";
+                        }
+
+                        Position start;
+                        start.setFromGame(game);
+                        gameRecorder.setStartFen(start.toFen());
+
                         // Update board display with the new game state
                         board.updateFromGame(game);
                         std::cout << "Time control: " << timeControls[selectedTimeControl].name << "\n";
@@ -746,6 +853,18 @@ int main() {
                     if (key->code == sf::Keyboard::Key::M) {
                         soundManager.toggleSound();
                     }
+
+                    // Toggle threat map overlay with T key
+                    if (key->code == sf::Keyboard::Key::T) {
+                        threatMapEnabled = !threatMapEnabled;
+                        std::cout << "Threat map " << (threatMapEnabled ? "ON" : "OFF") << "\n";
+                    }
+
+                    // Toggle live analysis with A key (human games only)
+                    if (key->code == sf::Keyboard::Key::A && opponentMode == OpponentMode::HUMAN) {
+                        liveAnalysisEnabled = !liveAnalysisEnabled;
+                        std::cout << "Live analysis " << (liveAnalysisEnabled ? "ON" : "OFF") << "\n";
+                    }
                 }
             }
         }
@@ -779,42 +898,119 @@ int main() {
             }
         }
 
+        // A finished game (mate or flag) makes a pending bot search obsolete
+        if (botThinking.valid() && (game.isGameOver() || timeExpired)) {
+            bot.stop();
+            botThinking.get();
+        }
+
         if (gameState == GameState::PLAYING &&
             opponentMode == OpponentMode::BOT &&
-                game.getTurn() == Color::BLACK &&
+                game.getTurn() == bot.getColor() &&
                 !isPromotionPending &&
                 !timeExpired &&
                 !game.isGameOver())
             {
-                auto mOpt = bot.pickMove(game);
-                if (mOpt) {
-                    Move m = *mOpt;
+                if (!botThinking.valid()) {
+                    // Search a snapshot on a worker thread so the window and the clocks keep running
+                    Position snapshot;
+                    snapshot.setFromGame(game);
+                    snapshot.setGamePly(static_cast<int>(gameRecorder.getMoveCount()));
+
+                    SearchLimits limits;
+                    double botClock = (bot.getColor() == Color::WHITE) ? whiteTimeSeconds : blackTimeSeconds;
+                    limits.timeLeftMs = static_cast<std::int64_t>(botClock * 1000.0);
+
+                    botThinking = std::async(std::launch::async, [&bot, snapshot, limits]() {
+                        return bot.searchMove(snapshot, limits);
+                    });
+                } else if (botThinking.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                    auto mOpt = botThinking.get();
+                    if (mOpt) {
+                        lastBotReport = bot.lastReport();
+                        game.makeMove(*mOpt);
+                        gameStarted = true; // żeby zegar zaczął lecieć
+                        board.updateFromGame(game);
+                        board.clearMarkedSquares();
+                        board.clearArrows();
 
-                    // bot zawsze promuje do hetmana
-                    if (m.isPromotion) {
-                        m.promotionPiece = PieceType::QUEEN;
-                    }
-                    
-                    Piece* p = game.getPiece(m.r1, m.c1);
-                    if (p && p->type == PieceType::PAWN && (m.r2 == 0 || m.r2 == 7)) {
-                        m.isPromotion = true;
-                        m.promotionPiece = PieceType::QUEEN;
+                        // (opcjonalnie) dopisz do historii, jeśli chcesz
+                        // moveHistory.push_back("bot move");
                     }
+                }
+            }
 
+        // Bitboard copy of the board for the live analysis and the threat map
+        Position boardPosition;
+        if (gameState == GameState::PLAYING && (liveAnalysisEnabled || threatMapEnabled)) {
+            boardPosition.setFromGame(game);
+        }
 
-
-
-                    game.makeMove(m);
-                    gameStarted = true; // żeby zegar zaczął lecieć
-                    board.updateFromGame(game);
-                    board.clearMarkedSquares();
-                    board.clearArrows();
-
-                    // (opcjonalnie) dopisz do historii, jeśli chcesz
-                    // moveHistory.push_back("bot move");
+        // Threat map: only the pieces a move touched (and sliders through those squares)
+        // are recomputed, and only when the board has changed
+        if (threatMapEnabled && gameState == GameState::PLAYING) {
+            if (!threatMapValid || boardPosition.key() != threatPosition.key()) {
+                if (threatMapValid) threatMap.update(threatPosition, boardPosition);
+                else threatMap.build(boardPosition);
+                threatPosition = boardPosition;
+                threatMapValid = true;
+
+                Board::SquareTints tints{};
+                for (int sq = 0; sq < 64; ++sq) {
+                    const int white = threatMap.attackers(Color::WHITE, sq);
+                    const int black = threatMap.attackers(Color::BLACK, sq);
+                    const auto alpha = static_cast<std::uint8_t>(std::min(40 + 30 * std::abs(white - black), 130));
+                    sf::Color& tint = tints[rowOf(sq)][colOf(sq)];
+                    if (white > black) tint = sf::Color(60, 130, 255, alpha);
+                    else if (black > white) tint = sf::Color(255, 90, 60, alpha);
+                    else if (white > 0) tint = sf::Color(240, 200, 40, 60); // contested
+                    else tint = sf::Color::Transparent;
+                }
+                std::vector<std::pair<int, int>> hanging;
+                Bitboard b = threatMap.hanging(boardPosition, Color::WHITE) | threatMap.hanging(boardPosition, Color::BLACK);
+                while (b) {
+                    const int sq = popLsb(b);
+                    hanging.push_back({rowOf(sq), colOf(sq)});
                 }
+                board.setThreatMap(tints, hanging);
             }
+        } else if (threatMapValid) {
+            board.clearThreatMap();
+            threatMapValid = false;
+        }
 
+        // Live analysis: hand every new position to the analyzer and pick up its newest
+        // result; neither call waits for the search thread
+        const bool liveAnalysisActive = liveAnalysisEnabled &&
+            gameState == GameState::PLAYING &&
+            opponentMode == OpponentMode::HUMAN &&
+            !isPromotionPending && !timeExpired && !game.isGameOver();
+        auto removeLiveArrow = [&]() {
+            if (liveArrow) board.removeArrow(liveArrow->r1, liveArrow->c1, liveArrow->r2, liveArrow->c2);
+            liveArrow.reset();
+        };
+        if (liveAnalysisActive) {
+            const Position& current = boardPosition;
+            if (current.key() != liveKey) {
+                liveKey = current.key();
+                liveAnalyzer.setPosition(current);
+                liveEval.reset();
+                removeLiveArrow();
+            }
+            LiveEvaluation eval;
+            if (liveAnalyzer.poll(eval) && eval.key == liveKey) {
+                liveEval = eval;
+                liveBestSan = current.toSan(eval.bestMove);
+                removeLiveArrow();
+                liveArrow = current.toGameMove(eval.bestMove);
+                board.addArrow(liveArrow->r1, liveArrow->c1, liveArrow->r2, liveArrow->c2, liveArrowColor);
+            }
+        } else if (liveKey != 0) {
+            liveAnalyzer.pause();
+            liveKey = 0;
+            liveEval.reset();
+            removeLiveArrow();
+        }
 
         window.clear();
 
@@ -948,6 +1144,51 @@ int main() {
                     window.draw(btnText);
                 }
 
+                // Bot strength buttons, next to the time controls
+                float strengthX = menuX + buttonWidth + 30.f;
+                float strengthButtonWidth = 180.f;
+                sf::Text strengthSubtitle(font, "Bot Strength", 20);
+                strengthSubtitle.setPosition({strengthX + 20.f, 175.f});
+                strengthSubtitle.setFillColor(sf::Color(200, 200, 200));
+                window.draw(strengthSubtitle);
+
+                for (int i = 0; i < STRENGTH_LEVEL_COUNT; ++i) {
+                    float btnY = menuY + i * spacing;
+
+                    sf::RectangleShape button({strengthButtonWidth, buttonHeight});
+                    button.setPosition({strengthX, btnY});
+
+                    if (i == selectedStrength) {
+                        button.setFillColor(sf::Color(180, 120, 80));
+                        button.setOutlineThickness(3.f);
+                        button.setOutlineColor(sf::Color(255, 180, 120));
+                    } else {
+                        button.setFillColor(sf::Color(60, 60, 80));
+                        button.setOutlineThickness(2.f);
+                        button.setOutlineColor(sf::Color(100, 100, 120));
+                    }
+                    window.draw(button);
+
+                    sf::Text btnText(font, STRENGTH_LEVELS[i].name, 20);
+                    btnText.setPosition({strengthX + 20.f, btnY + 12.f});
+                    btnText.setFillColor(sf::Color(255, 255, 255));
+                    window.draw(btnText);
+                }
+
+                // Engine toggle: alpha-beta or Monte Carlo tree search
+                float engineBtnY = menuY + STRENGTH_LEVEL_COUNT * spacing + 30.f;
+                sf::RectangleShape engineButton({strengthButtonWidth, buttonHeight});
+                engineButton.setPosition({strengthX, engineBtnY});
+                engineButton.setFillColor(sf::Color(60, 60, 80));
+                engineButton.setOutlineThickness(2.f);
+                engineButton.setOutlineColor(sf::Color(180, 120, 80));
+                window.draw(engineButton);
+
+                sf::Text engineText(font, selectedEngine == BotEngine::MCTS ? "Engine: MCTS" : "Engine: Alpha-Beta", 18);
+                engineText.setPosition({strengthX + 12.f, engineBtnY + 13.f});
+                engineText.setFillColor(sf::Color(255, 255, 255));
+                window.draw(engineText);
+
                 // START button
                 float startBtnY = menuY + timeControls.size() * spacing + 30.f;
                 sf::RectangleShape startButton({buttonWidth, buttonHeight});
@@ -1050,6 +1291,52 @@ int main() {
             drawClock("White", whiteTimeSeconds, 110.f, whiteActive, sf::Color(230, 230, 240));
             drawClock("Black", blackTimeSeconds, 170.f, blackActive, sf::Color(60, 60, 80));
 
+            // What the bot's last move cost, between the clocks and the controls
+            if (lastBotReport) {
+                sf::Text statsLabel(font, "Bot: " + lastBotReport->move + " (" + lastBotReport->source + ")", 12);
+                statsLabel.setPosition({10.f, 228.f});
+                statsLabel.setFillColor(sf::Color(200, 200, 200));
+                window.draw(statsLabel);
+
+                const SearchResult& r = lastBotReport->search;
+                if (lastBotReport->source == "search" || lastBotReport->source == "mcts") {
+                    std::ostringstream line1, line2, line3;
+                    line1 << "depth " << r.depth << "/" << r.selDepth << "   time " << std::fixed
+                          << std::setprecision(2) << r.timeMs / 1000.0 << " s";
+                    line2 << formatCount(r.nodes) << (lastBotReport->source == "mcts" ? " playouts   " : " nodes   ")
+                          << formatCount(r.nodesPerSecond()) << "/s";
+                    line3 << std::fixed << std::setprecision(2) << "EBF " << r.stats.effectiveBranching()
+                          << "   TT hits " << static_cast<int>(r.stats.ttHitRate() * 100) << "%";
+                    float y = 245.f;
+                    for (const std::string& text : {line1.str(), line2.str(), line3.str()}) {
+                        sf::Text statsText(font, text, 10);
+                        statsText.setPosition({10.f, y});
+                        statsText.setFillColor(sf::Color(150, 150, 150));
+                        window.draw(statsText);
+                        y += 15.f;
+                    }
+                }
+            } else if (liveEval) {
+                // Live analysis of the position on the board
+                std::ostringstream evalText;
+                const int score = liveEval->score;
+                if (std::abs(score) >= VALUE_MATE_IN_MAX_PLY) {
+                    const int moves = (VALUE_MATE - std::abs(score) + 1) / 2;
+                    evalText << "#" << (score > 0 ? moves : -moves);
+                } else {
+                    evalText << std::showpos << std::fixed << std::setprecision(2) << score / 100.0;
+                }
+                sf::Text evalLabel(font, "Analysis: " + evalText.str(), 12);
+                evalLabel.setPosition({10.f, 228.f});
+                evalLabel.setFillColor(sf::Color(200, 200, 200));
+                window.draw(evalLabel);
+
+                sf::Text evalDetail(font, "best " + liveBestSan + "   depth " + std::to_string(liveEval->depth), 10);
+                evalDetail.setPosition({10.f, 245.f});
+                evalDetail.setFillColor(sf::Color(150, 150, 150));
+                window.draw(evalDetail);
+            }
+
             // Controls
             sf::Text controlsLabel(font, "Controls:", 12);
             controlsLabel.setPosition({10.f, 300.f});
@@ -1081,13 +1368,25 @@ int main() {
             controls5.setFillColor(soundManager.isSoundEnabled() ? sf::Color(150, 255, 150) : sf::Color(255, 150, 150));
             window.draw(controls5);
 
+            sf::Text controls6(font, std::string("T: Threat map ") + (threatMapEnabled ? "ON" : "OFF"), 10);
+            controls6.setPosition({10.f, 395.f});
+            controls6.setFillColor(threatMapEnabled ? sf::Color(150, 255, 150) : sf::Color(150, 150, 150));
+            window.draw(controls6);
+
+            if (opponentMode == OpponentMode::HUMAN) {
+                sf::Text controls7(font, std::string("A: Analysis ") + (liveAnalysisEnabled ? "ON" : "OFF"), 10);
+                controls7.setPosition({10.f, 410.f});
+                controls7.setFillColor(liveAnalysisEnabled ? sf::Color(150, 255, 150) : sf::Color(150, 150, 150));
+                window.draw(controls7);
+            }
+
             // Move history
             sf::Text historyLabel(font, "Moves:", 12);
-            historyLabel.setPosition({10.f, 410.f});
+            historyLabel.setPosition({10.f, 430.f});
             historyLabel.setFillColor(sf::Color(200, 200, 200));
             window.draw(historyLabel);
 
-            int moveY = 430;
+            int moveY = 450;
             for (size_t i = 0; i < moveHistory.size() && i < 12; i++) {
                 std::string moveNum = std::to_string(i / 2 + 1) + ". " + moveHistory[i];
                 sf::Text moveText(font, moveNum, 10);
@@ -1108,6 +1407,26 @@ int main() {
         // Draw the board
         window.draw(board);
 
+        // Evaluation bar left of the board: White's share grows from the bottom
+        if (liveEval && gameState == GameState::PLAYING) {
+            double whiteShare;
+            if (std::abs(liveEval->score) >= VALUE_MATE_IN_MAX_PLY) {
+                whiteShare = liveEval->score > 0 ? 1.0 : 0.0;
+            } else {
+                whiteShare = 0.5 + 0.5 * std::tanh(liveEval->score / 400.0);
+            }
+            const float barWidth = 10.f;
+            const float whiteHeight = boardSize * static_cast<float>(whiteShare);
+            sf::RectangleShape blackPart({barWidth, boardSize});
+            blackPart.setPosition({boardX - barWidth - 5.f, boardY});
+            blackPart.setFillColor(sf::Color(50, 50, 60));
+            window.draw(blackPart);
+            sf::RectangleShape whitePart({barWidth, whiteHeight});
+            whitePart.setPosition({boardX - barWidth - 5.f, boardY + boardSize - whiteHeight});
+            whitePart.setFillColor(sf::Color(235, 235, 240));
+            window.draw(whitePart);
+        }
+
         // Draw drag preview circle while dragging
         if (isDragging && dragPreview.getRadius() > 0) {
             window.draw(dragPreview);
@@ -1239,11 +1558,24 @@ int main() {
             blackAvgText.setFillColor(sf::Color(170, 180, 230));
             window.draw(blackAvgText);
 
+            if (gameAnalyzer.busy()) {
+                textY += 25.f;
+                sf::Text analysisText(font, "Analiza partii w tle...", 16);
+                analysisText.setPosition({textX, textY});
+                analysisText.setFillColor(sf::Color(160, 200, 160));
+                window.draw(analysisText);
+            }
+
         }
 
 
         window.display();
     }
 
+    if (botThinking.valid()) {
+        bot.stop();
+        botThinking.get();
+    }
+
     return 0;
 }
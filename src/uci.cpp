@@ -0,0 +1,328 @@
+// UCI (Universal Chess Interface) front end for the engine, so that chess
+// GUIs, tournament managers and scripts can drive it over stdin/stdout.
+//
+// Supported commands: uci, isready, setoption, ucinewgame, position, go
+// (searchmoves wtime btime winc binc movestogo depth nodes movetime infinite ponder),
+// stop, ponderhit, quit. Searches run on a separate thread and stream "info"
+// lines after every completed iteration.
+//
+// Options: Hash, Threads, MultiPV, Ponder, UCI_Chess960, Style (AlphaBeta or
+// MCTS), EvalFile and TablebasePath. The network and tablebases are loaded
+// from the same default locations as the GUI.
+//
+// Usage:
+//   chess_uci
+
+#include "Engine/MctsSearch.hpp"
+#include "Engine/Nnue.hpp"
+#include "Engine/ParallelSearch.hpp"
+#include "Engine/Tablebase.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char* const START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+const char* const DEFAULT_EVAL_FILE = "../assets/nnue/network.bin";
+const char* const DEFAULT_TABLEBASE_PATH = "../assets/tablebases";
+constexpr int MAX_HASH_MB = 4096;
+constexpr int MAX_THREADS = 256;
+
+std::mutex outputMutex;
+
+// Whole-token integer, as UCI sends them (clocks may be negative)
+bool parseNumber(const std::string& s, std::int64_t& value) {
+    char* end = nullptr;
+    value = std::strtoll(s.c_str(), &end, 10);
+    return !s.empty() && *end == '\0';
+}
+
+// Whole lines only, so that search and command threads never interleave
+void send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(outputMutex);
+    std::cout << line << std::endl;
+}
+
+std::string scoreString(int score) {
+    if (std::abs(score) < VALUE_MATE_IN_MAX_PLY) return "cp " + std::to_string(score);
+    const int plies = VALUE_MATE - std::abs(score);
+    const int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+class UciEngine {
+public:
+    UciEngine() {
+        search_.setIterationCallback([this](const SearchResult& r) { sendInfo(r); });
+    }
+
+    ~UciEngine() { stopSearch(); }
+
+    void loop() {
+        std::string line;
+        while (std::getline(std::cin, line)) {
+            std::istringstream is(line);
+            std::string cmd;
+            is >> cmd;
+            if (cmd == "uci") uci();
+            else if (cmd == "isready") send("readyok");
+            else if (cmd == "setoption") setOption(is);
+            else if (cmd == "ucinewgame") newGame();
+            else if (cmd == "position") position(is);
+            else if (cmd == "go") go(is);
+            else if (cmd == "stop") stopSearch();
+            else if (cmd == "ponderhit") ponderHit();
+            else if (cmd == "quit") break;
+            else if (!cmd.empty()) send("info string unknown command " + cmd);
+        }
+    }
+
+private:
+    void uci() {
+        send("id name SFML_CHESS");
+        send("id author SFML_CHESS developers");
+        send("option name Hash type spin default 16 min 1 max " + std::to_string(MAX_HASH_MB));
+        send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+        send("option name MultiPV type spin default 1 min 1 max 64");
+        send("option name Ponder type check default false");
+        send("option name UCI_Chess960 type check default false");
+        send("option name Style type combo default AlphaBeta var AlphaBeta var MCTS");
+        send(std::string("option name EvalFile type string default ") + DEFAULT_EVAL_FILE);
+        send(std::string("option name TablebasePath type string default ") + DEFAULT_TABLEBASE_PATH);
+        send("uciok");
+    }
+
+    // setoption name <name with spaces> [value <value with spaces>]
+    void setOption(std::istringstream& is) {
+        std::string token, name, value;
+        is >> token; // "name"
+        while (is >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+        while (is >> token) value += (value.empty() ? "" : " ") + token;
+
+        stopSearch();
+        if (name == "Hash") {
+            search_.setHashSize(std::clamp(std::atoi(value.c_str()), 1, MAX_HASH_MB));
+        } else if (name == "Threads") {
+            threads_ = std::clamp(std::atoi(value.c_str()), 1, MAX_THREADS);
+            search_.setThreads(threads_);
+            mcts_.setThreads(threads_);
+        } else if (name == "MultiPV") {
+            multiPv_ = std::clamp(std::atoi(value.c_str()), 1, 64);
+        } else if (name == "Ponder") {
+            // Pondering is driven by "go ponder"; nothing to prepare
+        } else if (name == "UCI_Chess960") {
+            chess960_ = value == "true";
+        } else if (name == "Style") {
+            mctsStyle_ = value == "MCTS";
+        } else if (name == "EvalFile") {
+            send(std::string("info string ") + (Nnue::load(value) ? "loaded network " : "cannot load network ") + value);
+        } else if (name == "TablebasePath") {
+            send("info string loaded " + std::to_string(Tablebase::init(value)) + " tablebases from " + value);
+        } else {
+            send("info string unknown option " + name);
+        }
+    }
+
+    void newGame() {
+        stopSearch();
+        search_.clear();
+        mcts_.clear();
+    }
+
+    // position [startpos | fen <fen>] [moves <m1> ... <mN>]
+    void position(std::istringstream& is) {
+        std::string token, fen;
+        is >> token;
+        if (token == "startpos") {
+            fen = START_FEN;
+            is >> token; // "moves", if any
+        } else if (token == "fen") {
+            while (is >> token && token != "moves") fen += (fen.empty() ? "" : " ") + token;
+        } else {
+            return;
+        }
+
+        Position pos;
+        if (!pos.setFromFen(fen, chess960_)) {
+            send("info string invalid fen " + fen);
+            return;
+        }
+        while (is >> token) {
+            const EngineMove m = pos.parseUci(token);
+            if (m == NO_MOVE) {
+                send("info string illegal move " + token);
+                break;
+            }
+            pos.doMove(m);
+        }
+        stopSearch();
+        pos_ = pos;
+    }
+
+    void go(std::istringstream& is) {
+        SearchLimits limits;
+        bool infinite = false, ponder = false;
+        const bool white = pos_.sideToMove() == Color::WHITE;
+        std::vector<std::string> tokens;
+        for (std::string token; is >> token;) tokens.push_back(token);
+        for (std::size_t i = 0; i < tokens.size(); ++i) {
+            const std::string& token = tokens[i];
+            std::int64_t v = 0;
+            if (token == "infinite") infinite = true;
+            else if (token == "ponder") ponder = true;
+            else if (token == "searchmoves") {
+                // The moves run up to the next keyword
+                EngineMove m;
+                while (i + 1 < tokens.size() && (m = pos_.parseUci(tokens[i + 1])) != NO_MOVE) {
+                    limits.searchMoves.push_back(m);
+                    ++i;
+                }
+            }
+            else if (i + 1 < tokens.size() && parseNumber(tokens[i + 1], v)) {
+                ++i;
+                if (token == (white ? "wtime" : "btime")) limits.timeLeftMs = v;
+                else if (token == (white ? "winc" : "binc")) limits.incrementMs = v;
+                else if (token == "movestogo") limits.movesToGo = static_cast<int>(v);
+                else if (token == "depth") limits.depth = static_cast<int>(v);
+                else if (token == "nodes") limits.nodes = static_cast<std::uint64_t>(v);
+                else if (token == "movetime") limits.moveTimeMs = v;
+            }
+            // Anything else (unknown keywords and their arguments) is skipped
+        }
+        limits.multiPv = multiPv_;
+
+        stopSearch();
+        if (ponder) {
+            // Think on the opponent's time without a clock; ponderhit restarts with it
+            ponderLimits_ = limits;
+            SearchLimits unlimited;
+            unlimited.multiPv = limits.multiPv;
+            unlimited.searchMoves = limits.searchMoves;
+            startSearch(unlimited, true);
+        } else {
+            startSearch(limits, infinite);
+        }
+    }
+
+    // The predicted move was played: search again on our own clock. The hash table
+    // keeps what pondering found, so the first iterations are almost free.
+    void ponderHit() {
+        if (!searching_ || !pondering_) return;
+        discard_ = true;
+        stopSearch();
+        discard_ = false;
+        startSearch(ponderLimits_, false);
+    }
+
+    void startSearch(const SearchLimits& limits, bool waitForStop) {
+        searching_ = true;
+        thinking_ = true;
+        pondering_ = waitForStop;
+        waitForStop_ = waitForStop;
+        const Position pos = pos_;
+        thread_ = std::thread([this, pos, limits] {
+            SearchResult r = mctsStyle_ ? mcts_.think(pos, limits) : search_.think(pos, limits);
+            if (mctsStyle_) sendInfo(r);
+
+            // In infinite and ponder mode the move may only be sent after stop or ponderhit
+            {
+                std::unique_lock<std::mutex> lock(waitMutex_);
+                waitCv_.wait(lock, [this] { return !waitForStop_; });
+            }
+            thinking_ = false;
+            if (discard_) return;
+            std::string best = "bestmove " + pos.toUci(r.bestMove);
+            if (r.pv.size() > 1) {
+                Position next = pos;
+                next.doMove(r.pv[0]);
+                best += " ponder " + next.toUci(r.pv[1]);
+            }
+            send(best);
+        });
+    }
+
+    // Stop the running search (if any) and wait for its bestmove
+    void stopSearch() {
+        if (!searching_) return;
+        {
+            std::lock_guard<std::mutex> lock(waitMutex_);
+            waitForStop_ = false;
+        }
+        waitCv_.notify_all();
+        // The search may not have started yet and would clear a single request
+        while (thinking_) {
+            search_.stop();
+            mcts_.stop();
+            std::this_thread::yield();
+        }
+        thread_.join();
+        searching_ = false;
+        pondering_ = false;
+    }
+
+    void sendInfo(const SearchResult& r) {
+        const std::int64_t ms = std::max<std::int64_t>(r.timeMs, 1);
+        const std::uint64_t nps = r.nodes * 1000 / ms;
+        std::vector<SearchLine> lines = r.lines;
+        if (lines.empty()) lines.push_back(SearchLine{r.bestMove, r.score, r.depth, r.pv});
+
+        Position pos = pos_;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            std::ostringstream os;
+            os << "info depth " << lines[i].depth << " seldepth " << r.selDepth << " multipv " << i + 1
+               << " score " << scoreString(lines[i].score) << " nodes " << r.nodes << " nps " << nps;
+            if (!mctsStyle_) os << " hashfull " << search_.hashfull() << " tbhits " << r.stats.tbHits;
+            os << " time " << r.timeMs << " pv";
+            Position p = pos;
+            for (EngineMove m : lines[i].pv) {
+                os << " " << p.toUci(m);
+                p.doMove(m);
+            }
+            send(os.str());
+        }
+    }
+
+    ParallelSearch search_;
+    MctsSearch mcts_;
+    Position pos_ = [] {
+        Position p;
+        p.setFromFen(START_FEN);
+        return p;
+    }();
+
+    int threads_ = 1;
+    int multiPv_ = 1;
+    bool chess960_ = false;
+    bool mctsStyle_ = false;
+    SearchLimits ponderLimits_;
+
+    std::thread thread_;
+    bool searching_ = false;                // a search thread exists (command thread only)
+    bool pondering_ = false;
+    std::atomic<bool> thinking_{false};     // ... and has not returned from think() yet
+    std::atomic<bool> discard_{false};      // drop the bestmove of a finished ponder search
+    bool waitForStop_ = false;
+    std::mutex waitMutex_;
+    std::condition_variable waitCv_;
+};
+
+} // namespace
+
+int main() {
+    std::ios::sync_with_stdio(false);
+    Nnue::load(DEFAULT_EVAL_FILE);
+    Tablebase::init(DEFAULT_TABLEBASE_PATH);
+
+    UciEngine engine;
+    engine.loop();
+    return 0;
+}
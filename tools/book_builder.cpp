@@ -0,0 +1,162 @@
+// Builds opening books from the games GameRecorder saves in recent_games/.
+//
+// Every variant subdirectory (recent_games/<variant>/*.txt; files directly in
+// recent_games/ count as "standard") is parsed by a pool of threads. Each game
+// is replayed from its starting position (GameArchive.hpp) for up to --plies half
+// moves; every (position, move) pair is counted together with the game result.
+// The counts are written as a Polyglot-format book, sorted by key, to
+// <out-dir>/<variant>.bin, which OpeningBook memory-maps directly.
+//
+// Weights follow the Polyglot convention: 2 per win and 1 per draw for the
+// side that played the move. Moves seen in fewer than --min-games games or
+// never scoring are left out. The learn field holds the number of games.
+//
+// Usage:
+//   book_builder [--games-dir DIR] [--out-dir DIR] [--plies N] [--min-games N] [--threads N]
+
+#include "Engine/GameArchive.hpp"
+#include "Engine/OpeningBook.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    std::string gamesDir = "../recent_games";
+    std::string outDir = "../assets/books";
+    int plies = 24;
+    int minGames = 1;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--games-dir") opt.gamesDir = value;
+        else if (arg == "--out-dir") opt.outDir = value;
+        else if (arg == "--plies") opt.plies = std::stoi(value);
+        else if (arg == "--min-games") opt.minGames = std::max(1, std::stoi(value));
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+struct MoveStats {
+    std::uint32_t games = 0;
+    std::uint32_t points = 0; // 2 per win, 1 per draw, for the side that played the move
+};
+
+// (position key, polyglot move) -> stats
+using BookCounts = std::unordered_map<std::uint64_t, std::map<std::uint16_t, MoveStats>>;
+
+// Replay one game file into counts. Returns false if the game has no usable result
+// or its starting position is unknown.
+bool addGame(const fs::path& file, const std::string& variant, int plies, BookCounts& counts) {
+    ArchivedGame game;
+    Position pos;
+    if (!readArchivedGame(file, game) || game.result < 0) return false;
+    if (!archivedStartPosition(variant, game, pos)) return false;
+
+    for (int ply = 0; ply < plies && ply < static_cast<int>(game.moves.size()); ++ply) {
+        EngineMove m = parseRecordedMove(pos, game.moves[ply]);
+        if (m == NO_MOVE) break;
+        MoveStats& s = counts[polyglotKey(pos)][toPolyglotMove(m)];
+        ++s.games;
+        s.points += pos.sideToMove() == Color::WHITE ? game.result : 2 - game.result;
+        pos.doMove(m);
+    }
+    return true;
+}
+
+bool buildVariant(const Options& opt, const std::string& variant, const std::vector<fs::path>& files) {
+    // Each worker counts its share of the files; the maps are merged afterwards
+    std::vector<BookCounts> partial(opt.threads);
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> used{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::size_t i;
+            while ((i = next.fetch_add(1)) < files.size()) {
+                if (addGame(files[i], variant, opt.plies, partial[t])) ++used;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    BookCounts& counts = partial[0];
+    for (int t = 1; t < opt.threads; ++t) {
+        for (auto& [key, moves] : partial[t]) {
+            for (auto& [move, s] : moves) {
+                MoveStats& total = counts[key][move];
+                total.games += s.games;
+                total.points += s.points;
+            }
+        }
+    }
+
+    std::vector<PolyglotEntry> entries;
+    for (auto& [key, moves] : counts) {
+        for (auto& [move, s] : moves) {
+            if (s.games < static_cast<std::uint32_t>(opt.minGames) || s.points == 0) continue;
+            entries.push_back({key, move, static_cast<std::uint16_t>(std::min<std::uint32_t>(s.points, 0xFFFF)), s.games});
+        }
+    }
+    std::sort(entries.begin(), entries.end(), [](const PolyglotEntry& a, const PolyglotEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    fs::create_directories(opt.outDir);
+    const fs::path outPath = fs::path(opt.outDir) / (variant + ".bin");
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out) {
+        std::cerr << "Cannot write " << outPath.string() << "\n";
+        return false;
+    }
+    std::uint8_t buffer[POLYGLOT_ENTRY_SIZE];
+    for (const PolyglotEntry& e : entries) {
+        writePolyglotEntry(e, buffer);
+        out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+    std::cout << variant << ": " << used << " of " << files.size() << " games, " << counts.size() << " positions, "
+              << entries.size() << " entries -> " << outPath.string() << "\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+    if (!fs::is_directory(opt.gamesDir)) {
+        std::cerr << "No games directory " << opt.gamesDir << "\n";
+        return 1;
+    }
+
+    const auto byVariant = listArchive(opt.gamesDir);
+    bool ok = true;
+    for (const auto& [variant, files] : byVariant) ok = buildVariant(opt, variant, files) && ok;
+    return ok ? 0 : 1;
+}
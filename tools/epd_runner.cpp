@@ -0,0 +1,300 @@
+// Runs EPD test suites (WAC, ECM, STS, ...) to measure tactical strength and speed.
+//
+// Each EPD line is a position (the first four FEN fields) followed by operations:
+//
+//   r1b1k2r/ppppnppp/2n2q2/2b5/3NP3/2P1B3/PP3PPP/RN1QKB1R w KQkq - bm Nxc6; id "test.001";
+//
+// bm lists the best moves (a position is solved if the engine plays one of them),
+// am the moves to avoid (solved if it plays none of them); moves are SAN or UCI.
+// Positions are spread over a pool of threads, each searching one position at
+// a time with its own Search and the given time, node or depth limit.
+//
+// Time to solution is when the search settled on a right move for good: the
+// first completed iteration after which every later iteration (and the final
+// answer) was correct. The summary gives the solve rate, the average and total
+// time to solution, and nodes per second per thread and for the whole run.
+//
+// Usage:
+//   epd_runner FILE.epd [FILE.epd ...] [--movetime MS] [--nodes N] [--depth N]
+//              [--threads N] [--hash MB] [--network FILE] [--tablebases DIR] [--quiet]
+
+#include "Engine/Nnue.hpp"
+#include "Engine/Search.hpp"
+#include "Engine/Tablebase.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> files;
+    SearchLimits limits;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t hashMb = 16;
+    std::string network;
+    std::string tablebases = "../assets/tablebases";
+    bool quiet = false;
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--quiet") {
+            opt.quiet = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            opt.files.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--movetime") opt.limits.moveTimeMs = std::stoll(value);
+        else if (arg == "--nodes") opt.limits.nodes = std::stoull(value);
+        else if (arg == "--depth") opt.limits.depth = std::stoi(value);
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else if (arg == "--hash") opt.hashMb = std::max(1, std::stoi(value));
+        else if (arg == "--network") opt.network = value;
+        else if (arg == "--tablebases") opt.tablebases = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.files.empty()) {
+        std::cerr << "Usage: epd_runner FILE.epd [...] [--movetime MS] [--nodes N] [--depth N] [--threads N]\n";
+        return false;
+    }
+    if (!opt.limits.moveTimeMs && !opt.limits.nodes && !opt.limits.depth) opt.limits.moveTimeMs = 1000;
+    return true;
+}
+
+struct EpdEntry {
+    std::string id;
+    Position pos;
+    std::vector<EngineMove> best;   // bm
+    std::vector<EngineMove> avoid;  // am
+    std::string bestText, avoidText;
+};
+
+// SAN without check marks and annotations, castling with letter O
+std::string normalizeSan(std::string san) {
+    san.erase(std::remove_if(san.begin(), san.end(), [](char c) { return c == '+' || c == '#' || c == '!' || c == '?'; }),
+              san.end());
+    std::replace(san.begin(), san.end(), '0', 'O');
+    return san;
+}
+
+EngineMove parseMove(const Position& pos, const std::string& text) {
+    if (EngineMove m = pos.parseUci(text)) return m;
+    const std::string want = normalizeSan(text);
+    MoveList legal;
+    pos.legalMoves(legal);
+    for (EngineMove m : legal) {
+        if (normalizeSan(pos.toSan(m)) == want) return m;
+    }
+    return NO_MOVE;
+}
+
+std::string trim(const std::string& s) {
+    const std::size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return "";
+    return s.substr(b, s.find_last_not_of(" \t\r\n") - b + 1);
+}
+
+bool parseEpd(const std::string& line, EpdEntry& e, std::string& error) {
+    std::istringstream is(line);
+    std::string fields[4];
+    for (std::string& f : fields) {
+        if (!(is >> f)) {
+            error = "fewer than four FEN fields";
+            return false;
+        }
+    }
+    if (!e.pos.setFromFen(fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3] + " 0 1")) {
+        error = "bad position";
+        return false;
+    }
+
+    std::string rest;
+    std::getline(is, rest);
+    std::stringstream ops(rest);
+    for (std::string op; std::getline(ops, op, ';');) {
+        std::istringstream os(trim(op));
+        std::string code;
+        os >> code;
+        std::string args;
+        std::getline(os, args);
+        args = trim(args);
+        if (code == "id") {
+            e.id = args;
+            e.id.erase(std::remove(e.id.begin(), e.id.end(), '"'), e.id.end());
+        } else if (code == "bm" || code == "am") {
+            std::istringstream ms(args);
+            for (std::string text; ms >> text;) {
+                const EngineMove m = parseMove(e.pos, text);
+                if (m == NO_MOVE) {
+                    error = "illegal move " + text;
+                    return false;
+                }
+                (code == "bm" ? e.best : e.avoid).push_back(m);
+            }
+            (code == "bm" ? e.bestText : e.avoidText) = args;
+        }
+    }
+    if (e.best.empty() && e.avoid.empty()) {
+        error = "no bm or am";
+        return false;
+    }
+    return true;
+}
+
+bool isCorrect(const EpdEntry& e, EngineMove m) {
+    if (!e.best.empty() && std::find(e.best.begin(), e.best.end(), m) == e.best.end()) return false;
+    return std::find(e.avoid.begin(), e.avoid.end(), m) == e.avoid.end();
+}
+
+struct EpdResult {
+    bool solved = false;
+    std::int64_t solutionMs = 0;    // time to solution, valid when solved
+    int solutionDepth = 0;
+    EngineMove move = NO_MOVE;
+    int depth = 0;
+    std::uint64_t nodes = 0;
+    std::int64_t timeMs = 0;
+};
+
+EpdResult solve(Search& search, const EpdEntry& e, const SearchLimits& limits) {
+    // Earliest iteration from which the best move stayed correct
+    std::int64_t settledMs = -1;
+    int settledDepth = 0;
+    search.setIterationCallback([&](const SearchResult& r) {
+        if (!isCorrect(e, r.bestMove)) {
+            settledMs = -1;
+        } else if (settledMs < 0) {
+            settledMs = r.timeMs;
+            settledDepth = r.depth;
+        }
+    });
+    search.clear();
+    const SearchResult r = search.think(e.pos, limits);
+    search.setIterationCallback(nullptr);
+
+    EpdResult res;
+    res.move = r.bestMove;
+    res.depth = r.depth;
+    res.nodes = r.nodes;
+    res.timeMs = r.timeMs;
+    res.solved = isCorrect(e, r.bestMove);
+    if (res.solved) {
+        res.solutionMs = settledMs >= 0 ? settledMs : r.timeMs;
+        res.solutionDepth = settledMs >= 0 ? settledDepth : r.depth;
+    }
+    return res;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+    Tablebase::init(opt.tablebases);
+    if (!opt.network.empty() && !Nnue::load(opt.network)) {
+        std::cerr << "Cannot load network " << opt.network << "\n";
+        return 1;
+    }
+
+    std::vector<EpdEntry> entries;
+    for (const std::string& file : opt.files) {
+        std::ifstream in(file);
+        if (!in) {
+            std::cerr << "Cannot open " << file << "\n";
+            return 1;
+        }
+        int lineNo = 0;
+        for (std::string line; std::getline(in, line);) {
+            ++lineNo;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') continue;
+            EpdEntry e;
+            std::string error;
+            if (!parseEpd(line, e, error)) {
+                std::cerr << file << ":" << lineNo << ": skipped, " << error << "\n";
+                continue;
+            }
+            if (e.id.empty()) e.id = file + ":" + std::to_string(lineNo);
+            entries.push_back(std::move(e));
+        }
+    }
+    if (entries.empty()) {
+        std::cerr << "No positions\n";
+        return 1;
+    }
+    const int threads = std::min<int>(opt.threads, static_cast<int>(entries.size()));
+    std::cout << entries.size() << " positions, " << threads << " threads\n";
+
+    std::vector<EpdResult> results(entries.size());
+    std::atomic<std::size_t> next{0};
+    std::mutex consoleMutex;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            Search search;
+            search.setHashSize(opt.hashMb);
+            for (std::size_t i; (i = next.fetch_add(1)) < entries.size();) {
+                const EpdEntry& e = entries[i];
+                results[i] = solve(search, e, opt.limits);
+                if (opt.quiet) continue;
+
+                const EpdResult& r = results[i];
+                std::ostringstream os;
+                os << std::left << std::setw(16) << e.id << (r.solved ? " solved " : " FAILED ") << std::right
+                   << std::setw(6) << e.pos.toSan(r.move) << "  depth " << std::setw(2) << r.depth;
+                if (r.solved) os << "  found in " << std::fixed << std::setprecision(2) << r.solutionMs / 1000.0 << " s";
+                else os << "  expected " << (e.bestText.empty() ? "not " + e.avoidText : e.bestText);
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                std::cout << os.str() << "\n";
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int solved = 0;
+    std::int64_t solutionMs = 0, searchMs = 0;
+    std::uint64_t nodes = 0;
+    for (const EpdResult& r : results) {
+        if (r.solved) {
+            ++solved;
+            solutionMs += r.solutionMs;
+        }
+        searchMs += r.timeMs;
+        nodes += r.nodes;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nSolved " << solved << " / " << entries.size() << " ("
+              << 100.0 * solved / entries.size() << "%)\n"
+              << std::setprecision(2)
+              << "Time to solution: average " << (solved ? solutionMs / 1000.0 / solved : 0.0)
+              << " s, total " << solutionMs / 1000.0 << " s\n"
+              << "Nodes: " << nodes << ", " << static_cast<std::uint64_t>(nodes * 1000.0 / std::max<std::int64_t>(searchMs, 1))
+              << " nps per thread, " << static_cast<std::uint64_t>(nodes / std::max(wallSeconds, 0.001))
+              << " nps total in " << wallSeconds << " s\n";
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Generates the KPK bitbase (src/Engine/Kpk.hpp) by retrograde analysis and
+// writes it as a C++ source file. Run by CMake at build time:
+//   kpk_generator <output.cpp>
+//
+// Every position starts as INVALID, DRAW, WIN or UNKNOWN from static rules
+// (illegal placements, safe promotions, stalemates, pawn captures). UNKNOWN
+// positions are then classified from their successors until nothing changes:
+// White to move wins if some move wins, Black to move draws if some move
+// draws. Whatever is still unknown at the end cannot be forced: a draw.
+
+#include "Engine/Kpk.hpp"
+
+#include <cstdio>
+#include <vector>
+
+using namespace Bitboards;
+
+namespace {
+
+enum Result : std::uint8_t { INVALID, UNKNOWN, DRAW, WIN };
+
+struct KpkPosition {
+    Color stm;
+    int wk, bk, psq;
+};
+
+KpkPosition decode(int idx) {
+    KpkPosition p;
+    p.bk = idx & 63;
+    p.wk = (idx >> 6) & 63;
+    p.stm = static_cast<Color>((idx >> 12) & 1);
+    const int pawnIdx = idx >> 13;
+    p.psq = squareOf(pawnIdx % 6 + 1, pawnIdx / 6);
+    return p;
+}
+
+bool adjacent(int a, int b) { return kingAttacks(a) & squareBB(b); }
+
+Result initial(const KpkPosition& p) {
+    const Bitboard pawnAtt = pawnAttacks(Color::WHITE, p.psq);
+    if (p.wk == p.bk || p.wk == p.psq || p.bk == p.psq || adjacent(p.wk, p.bk)) return INVALID;
+    if (p.stm == Color::WHITE && (pawnAtt & squareBB(p.bk))) return INVALID;
+
+    if (p.stm == Color::WHITE) {
+        // Promotion that the black king cannot answer by capturing the new queen
+        const int push = p.psq - 8;
+        if (rowOf(p.psq) == 1 && push != p.wk && push != p.bk && (!adjacent(p.bk, push) || adjacent(p.wk, push))) {
+            return WIN;
+        }
+        return UNKNOWN;
+    }
+
+    // Black to move: stalemate, or an undefended pawn next to the black king
+    const Bitboard blackMoves = kingAttacks(p.bk) & ~(kingAttacks(p.wk) | pawnAtt);
+    if (!blackMoves) return DRAW;
+    if ((blackMoves & squareBB(p.psq)) && !adjacent(p.wk, p.psq)) return DRAW;
+    return UNKNOWN;
+}
+
+Result classify(const std::vector<Result>& db, const KpkPosition& p) {
+    // Results of successors, reduced to "some child wins/draws" and "all children win/draw"
+    bool anyWin = false, anyDraw = false, anyUnknown = false;
+    auto visit = [&](Result r) {
+        if (r == WIN) anyWin = true;
+        else if (r == DRAW) anyDraw = true;
+        else if (r == UNKNOWN) anyUnknown = true;
+    };
+
+    if (p.stm == Color::WHITE) {
+        for (Bitboard b = kingAttacks(p.wk) & ~kingAttacks(p.bk) & ~squareBB(p.psq); b;) {
+            visit(db[Kpk::index(Color::BLACK, popLsb(b), p.bk, p.psq)]);
+        }
+        if (rowOf(p.psq) > 1) {
+            const int push = p.psq - 8;
+            if (push != p.wk && push != p.bk) {
+                visit(db[Kpk::index(Color::BLACK, p.wk, p.bk, push)]);
+                const int doublePush = push - 8;
+                if (rowOf(p.psq) == 6 && doublePush != p.wk && doublePush != p.bk) {
+                    visit(db[Kpk::index(Color::BLACK, p.wk, p.bk, doublePush)]);
+                }
+            }
+        }
+        if (anyWin) return WIN;
+        return anyUnknown ? UNKNOWN : DRAW;
+    }
+
+    const Bitboard blocked = kingAttacks(p.wk) | pawnAttacks(Color::WHITE, p.psq) | squareBB(p.psq);
+    for (Bitboard b = kingAttacks(p.bk) & ~blocked; b;) {
+        visit(db[Kpk::index(Color::WHITE, p.wk, popLsb(b), p.psq)]);
+    }
+    if (anyDraw) return DRAW;
+    return anyUnknown ? UNKNOWN : WIN;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: kpk_generator <output.cpp>\n");
+        return 1;
+    }
+
+    std::vector<Result> db(Kpk::SIZE);
+    for (int i = 0; i < Kpk::SIZE; ++i) db[i] = initial(decode(i));
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (int i = 0; i < Kpk::SIZE; ++i) {
+            if (db[i] != UNKNOWN) continue;
+            Result r = classify(db, decode(i));
+            if (r != UNKNOWN) {
+                db[i] = r;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> bits(Kpk::SIZE / 32, 0);
+    int wins = 0;
+    for (int i = 0; i < Kpk::SIZE; ++i) {
+        if (db[i] == WIN) {
+            bits[i >> 5] |= 1u << (i & 31);
+            ++wins;
+        }
+    }
+
+    FILE* out = std::fopen(argv[1], "w");
+    if (!out) {
+        std::fprintf(stderr, "kpk_generator: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    std::fprintf(out, "// Generated by tools/kpk_generator, do not edit. %d winning positions.\n", wins);
+    std::fprintf(out, "#include \"Engine/Kpk.hpp\"\n\nconst std::uint32_t Kpk::BITBASE[Kpk::SIZE / 32] = {\n");
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        std::fprintf(out, "%s0x%08X,%s", i % 8 == 0 ? "    " : " ", bits[i], i % 8 == 7 ? "\n" : "");
+    }
+    std::fprintf(out, "};\n");
+    return std::fclose(out) == 0 ? 0 : 1;
+}
@@ -0,0 +1,431 @@
+// Plays bot-vs-bot matches to measure whether one configuration is stronger.
+//
+// Games run concurrently on a pool of threads, each with its own pair of
+// searches. Every opening is played twice with colours swapped. Players are
+// described by comma-separated key=value settings:
+//
+//   name=...        label in the PGN and the summary
+//   nodes=N         node budget per move          depth=N      depth limit
+//   movetime=MS     fixed time per move           tc=S+I       clock, seconds + increment
+//   noise=CP        evaluation noise              seed=N       noise seed
+//   level=NAME      a strength level from Strength.hpp (Beginner, Club, ...)
+//   engine=mcts     Monte Carlo tree search (nodes = playouts) instead of alpha-beta
+//   nmp=0 lmr=0     switch off null-move pruning or late-move reductions
+//   futility=0      ... futility pruning     razor=0      ... razoring
+//
+// The score of player A gives an Elo difference with a 95% interval. With
+// --sprt ELO0,ELO1 the match stops as soon as the sequential probability ratio
+// test accepts either hypothesis (normal approximation of the trinomial
+// game results, as used by most engine testing frameworks).
+//
+// All games are appended to <out>/games.pgn, the final numbers to <out>/summary.txt.
+//
+// Usage:
+//   match_runner --a SPEC --b SPEC [--games N] [--threads N] [--openings FILE]
+//                [--sprt ELO0,ELO1] [--alpha A] [--beta B] [--max-plies N] [--out DIR]
+
+#include "Engine/MctsSearch.hpp"
+#include "Engine/Search.hpp"
+#include "Engine/Strength.hpp"
+#include "Engine/Tablebase.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Player {
+    std::string name;
+    SearchLimits limits;
+    double clockSeconds = 0.0;   // 0 = no clock
+    double incrementSeconds = 0.0;
+    bool mcts = false;
+};
+
+// The searches of one player, kept across the games of a worker thread
+struct PlayerSearch {
+    Search alphaBeta;
+    MctsSearch mcts{1};
+
+    void clear() {
+        alphaBeta.clear();
+        mcts.clear();
+    }
+    SearchResult think(const Player& p, const Position& pos, const SearchLimits& limits) {
+        return p.mcts ? mcts.think(pos, limits) : alphaBeta.think(pos, limits);
+    }
+};
+
+struct Options {
+    Player a, b;
+    int games = 100;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string openingsFile;
+    bool sprt = false;
+    double elo0 = 0.0, elo1 = 5.0;
+    double alpha = 0.05, beta = 0.05;
+    int maxPlies = 400;
+    std::string outDir = "match_results";
+    std::string tablebases = "../assets/tablebases";
+};
+
+bool parsePlayer(const std::string& spec, const std::string& defaultName, Player& p) {
+    p.name = defaultName;
+    std::stringstream ss(spec);
+    for (std::string item; std::getline(ss, item, ',');) {
+        const std::size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "Bad player setting " << item << "\n";
+            return false;
+        }
+        const std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+        if (key == "name") p.name = value;
+        else if (key == "nodes") p.limits.nodes = std::stoull(value);
+        else if (key == "depth") p.limits.depth = std::stoi(value);
+        else if (key == "movetime") p.limits.moveTimeMs = std::stoll(value);
+        else if (key == "noise") p.limits.evalNoise = std::stoi(value);
+        else if (key == "seed") p.limits.noiseSeed = std::stoull(value);
+        else if (key == "engine" && (value == "mcts" || value == "alphabeta")) p.mcts = value == "mcts";
+        else if (key == "nmp") p.limits.nullMove = value != "0";
+        else if (key == "lmr") p.limits.lateMoveReductions = value != "0";
+        else if (key == "futility") p.limits.futility = value != "0";
+        else if (key == "razor") p.limits.razoring = value != "0";
+        else if (key == "tc") {
+            const std::size_t plus = value.find('+');
+            p.clockSeconds = std::stod(value.substr(0, plus));
+            p.incrementSeconds = plus == std::string::npos ? 0.0 : std::stod(value.substr(plus + 1));
+        } else if (key == "level") {
+            bool found = false;
+            for (const StrengthLevel& level : STRENGTH_LEVELS) {
+                if (value == level.name) {
+                    p.limits.nodes = level.nodes;
+                    p.limits.evalNoise = level.evalNoise;
+                    found = true;
+                }
+            }
+            if (!found) {
+                std::cerr << "Unknown strength level " << value << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown player setting " << key << "\n";
+            return false;
+        }
+    }
+    const SearchLimits& l = p.limits;
+    if (!l.nodes && !l.depth && !l.moveTimeMs && p.clockSeconds <= 0.0) {
+        std::cerr << p.name << ": give nodes, depth, movetime or tc\n";
+        return false;
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    std::string specA = "nodes=20000", specB = "nodes=20000";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--a") specA = value;
+        else if (arg == "--b") specB = value;
+        else if (arg == "--games") opt.games = std::max(2, std::stoi(value));
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else if (arg == "--openings") opt.openingsFile = value;
+        else if (arg == "--sprt") {
+            opt.sprt = true;
+            const std::size_t comma = value.find(',');
+            opt.elo0 = std::stod(value.substr(0, comma));
+            opt.elo1 = comma == std::string::npos ? opt.elo0 + 5.0 : std::stod(value.substr(comma + 1));
+        } else if (arg == "--alpha") opt.alpha = std::stod(value);
+        else if (arg == "--beta") opt.beta = std::stod(value);
+        else if (arg == "--max-plies") opt.maxPlies = std::stoi(value);
+        else if (arg == "--out") opt.outDir = value;
+        else if (arg == "--tablebases") opt.tablebases = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    opt.games += opt.games % 2; // whole colour-swapped pairs
+    return parsePlayer(specA, "A", opt.a) && parsePlayer(specB, "B", opt.b);
+}
+
+// Short, roughly balanced openings (UCI moves from the standard position)
+const char* const DEFAULT_OPENINGS[] = {
+    "e2e4 e7e5 g1f3 b8c6",       "e2e4 c7c5 g1f3 d7d6",        "e2e4 c7c5 b1c3 b8c6",
+    "e2e4 e7e6 d2d4 d7d5",       "e2e4 c7c6 d2d4 d7d5",        "e2e4 d7d6 d2d4 g8f6",
+    "e2e4 e7e5 f1c4 g8f6",       "e2e4 g7g6 d2d4 f8g7",        "d2d4 d7d5 c2c4 e7e6",
+    "d2d4 d7d5 c2c4 c7c6",       "d2d4 g8f6 c2c4 g7g6",        "d2d4 g8f6 c2c4 e7e6",
+    "d2d4 f7f5 g2g3 g8f6",       "d2d4 d7d5 g1f3 g8f6",        "c2c4 e7e5 b1c3 g8f6",
+    "c2c4 c7c5 g1f3 b8c6",       "g1f3 d7d5 g2g3 g8f6",        "g1f3 g8f6 c2c4 b7b6",
+    "e2e4 e7e5 b1c3 g8f6",       "d2d4 g8f6 g1f3 d7d5",        "e2e4 d7d5 e4d5 d8d5",
+    "b2b3 e7e5 c1b2 b8c6",       "e2e4 b7b6 d2d4 c8b7",        "d2d4 c7c5 d4d5 e7e5",
+};
+
+// An opening is a FEN (contains '/') or UCI moves from the standard position
+bool openingPosition(const std::string& line, Position& pos) {
+    if (line.find('/') != std::string::npos) return pos.setFromFen(line);
+    pos.setFromFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    std::stringstream ss(line);
+    for (std::string uci; ss >> uci;) {
+        EngineMove m = pos.parseUci(uci);
+        if (m == NO_MOVE) return false;
+        pos.doMove(m);
+    }
+    return true;
+}
+
+struct GameRecord {
+    int round = 0;
+    bool aIsWhite = true;
+    std::string startFen;
+    std::vector<std::string> san;
+    std::string result;        // "1-0", "0-1", "1/2-1/2"
+    std::string termination;
+};
+
+// One game between two players; `white` and `black` keep their searches (and
+// hash tables) for the whole game
+GameRecord playGame(const Options& opt, const Player& white, const Player& black,
+                    PlayerSearch& whiteSearch, PlayerSearch& blackSearch, const Position& start) {
+    GameRecord g;
+    g.startFen = start.toFen();
+    whiteSearch.clear();
+    blackSearch.clear();
+
+    Position pos = start;
+    pos.setGamePly(0);
+    double clock[2] = {white.clockSeconds, black.clockSeconds};
+
+    for (int ply = 0;; ++ply) {
+        MoveList legal;
+        pos.legalMoves(legal);
+        if (legal.size == 0) {
+            const bool whiteMated = pos.sideToMove() == Color::WHITE;
+            g.result = !pos.inCheck() ? "1/2-1/2" : whiteMated ? "0-1" : "1-0";
+            g.termination = pos.inCheck() ? "checkmate" : "stalemate";
+            return g;
+        }
+        if (pos.isDraw()) {
+            g.result = "1/2-1/2";
+            g.termination = pos.halfmoveClock() >= 100 ? "fifty moves" : "repetition or material";
+            return g;
+        }
+        if (ply >= opt.maxPlies) {
+            g.result = "1/2-1/2";
+            g.termination = "move limit";
+            return g;
+        }
+        // Solved endings are adjudicated from the tablebases
+        TbResult tb;
+        if (Tablebase::probe(pos, tb) && popCount(pos.pieces()) > 2) {
+            const bool whiteWins = (tb.wdl > 0) == (pos.sideToMove() == Color::WHITE);
+            g.result = tb.wdl == 0 ? "1/2-1/2" : whiteWins ? "1-0" : "0-1";
+            g.termination = "tablebase";
+            return g;
+        }
+
+        const int side = static_cast<int>(pos.sideToMove());
+        const Player& p = side == 0 ? white : black;
+        SearchLimits limits = p.limits;
+        if (p.clockSeconds > 0.0) {
+            limits.timeLeftMs = static_cast<std::int64_t>(clock[side] * 1000.0);
+            limits.incrementMs = static_cast<std::int64_t>(p.incrementSeconds * 1000.0);
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        SearchResult r = (side == 0 ? whiteSearch : blackSearch).think(p, pos, limits);
+        const double used = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (p.clockSeconds > 0.0) {
+            clock[side] -= used;
+            if (clock[side] < 0.0) {
+                g.result = side == 0 ? "0-1" : "1-0";
+                g.termination = "time forfeit";
+                return g;
+            }
+            clock[side] += p.incrementSeconds;
+        }
+
+        g.san.push_back(pos.toSan(r.bestMove));
+        pos.doMove(r.bestMove);
+    }
+}
+
+void writePgn(std::ostream& out, const GameRecord& g, const Options& opt) {
+    const std::string& white = g.aIsWhite ? opt.a.name : opt.b.name;
+    const std::string& black = g.aIsWhite ? opt.b.name : opt.a.name;
+    out << "[Event \"match_runner\"]\n[Site \"local\"]\n[Round \"" << g.round << "\"]\n"
+        << "[White \"" << white << "\"]\n[Black \"" << black << "\"]\n[Result \"" << g.result << "\"]\n"
+        << "[SetUp \"1\"]\n[FEN \"" << g.startFen << "\"]\n[Termination \"" << g.termination << "\"]\n\n";
+
+    Position pos;
+    pos.setFromFen(g.startFen);
+    int moveNumber = std::stoi(g.startFen.substr(g.startFen.rfind(' ') + 1));
+    bool whiteToMove = pos.sideToMove() == Color::WHITE;
+    std::string line;
+    auto emit = [&](const std::string& token) {
+        if (line.size() + token.size() + 1 > 79) {
+            out << line << "\n";
+            line.clear();
+        }
+        if (!line.empty()) line += ' ';
+        line += token;
+    };
+    for (std::size_t i = 0; i < g.san.size(); ++i) {
+        if (whiteToMove) emit(std::to_string(moveNumber) + ".");
+        else if (i == 0) emit(std::to_string(moveNumber) + "...");
+        emit(g.san[i]);
+        if (!whiteToMove) ++moveNumber;
+        whiteToMove = !whiteToMove;
+    }
+    emit(g.result);
+    out << line << "\n\n";
+}
+
+// Match statistics from player A's point of view
+struct Score {
+    int wins = 0, draws = 0, losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    double mean() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+    double variance() const {
+        const double s = mean();
+        return games() ? (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games() : 0.0;
+    }
+};
+
+double eloFromScore(double s) {
+    s = std::clamp(s, 1e-6, 1 - 1e-6);
+    return -400.0 * std::log10(1.0 / s - 1.0);
+}
+
+double scoreFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// Log-likelihood ratio of elo1 against elo0
+double sprtLlr(const Score& sc, double elo0, double elo1) {
+    if (sc.games() == 0) return 0.0;
+    // Half a pseudo-game per outcome: a short or one-sided run would otherwise have
+    // no variance at all, and the test could never conclude (or conclude at once)
+    const double w = sc.wins + 0.5, d = sc.draws + 0.5, l = sc.losses + 0.5, n = w + d + l;
+    const double m = (w + 0.5 * d) / n;
+    const double var = (w * (1 - m) * (1 - m) + d * (0.5 - m) * (0.5 - m) + l * m * m) / n;
+    const double s0 = scoreFromElo(elo0), s1 = scoreFromElo(elo1);
+    return sc.games() * (s1 - s0) * (2 * m - s0 - s1) / (2 * var);
+}
+
+std::string summarize(const Score& sc, const Options& opt, double llr) {
+    std::ostringstream os;
+    const double se = sc.games() ? std::sqrt(sc.variance() / sc.games()) : 0.0;
+    const double elo = eloFromScore(sc.mean());
+    const double lo = eloFromScore(sc.mean() - 1.96 * se), hi = eloFromScore(sc.mean() + 1.96 * se);
+    os << std::fixed << std::setprecision(1) << opt.a.name << " vs " << opt.b.name << ": " << sc.games()
+       << " games, +" << sc.wins << " =" << sc.draws << " -" << sc.losses << ", score "
+       << 100.0 * sc.mean() << "%, Elo " << elo << " [" << lo << ", " << hi << "]";
+    if (opt.sprt) {
+        os << std::setprecision(2) << ", LLR " << llr << " (" << std::log(opt.beta / (1 - opt.alpha)) << ", "
+           << std::log((1 - opt.beta) / opt.alpha) << ")";
+    }
+    return os.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+    Tablebase::init(opt.tablebases);
+
+    std::vector<std::string> openings;
+    if (!opt.openingsFile.empty()) {
+        std::ifstream in(opt.openingsFile);
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty() && line[0] != '#') openings.push_back(line);
+        }
+    } else {
+        openings.assign(std::begin(DEFAULT_OPENINGS), std::end(DEFAULT_OPENINGS));
+    }
+    std::vector<Position> starts;
+    for (const std::string& line : openings) {
+        Position pos;
+        if (openingPosition(line, pos)) starts.push_back(pos);
+        else std::cerr << "Skipping bad opening: " << line << "\n";
+    }
+    if (starts.empty()) {
+        std::cerr << "No openings\n";
+        return 1;
+    }
+
+    fs::create_directories(opt.outDir);
+    std::ofstream pgn(fs::path(opt.outDir) / "games.pgn", std::ios::app);
+    if (!pgn) {
+        std::cerr << "Cannot write to " << opt.outDir << "\n";
+        return 1;
+    }
+
+    const double lowerBound = std::log(opt.beta / (1 - opt.alpha));
+    const double upperBound = std::log((1 - opt.beta) / opt.alpha);
+    std::mutex mutex; // guards score, pgn, verdict and the console
+    Score score;
+    std::string verdict;
+    std::atomic<int> nextGame{0};
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; ++t) {
+        workers.emplace_back([&] {
+            PlayerSearch searchA, searchB;
+            int game;
+            while (!stop && (game = nextGame.fetch_add(1)) < opt.games) {
+                // Games 2k and 2k+1 play the same opening with colours swapped
+                const Position& start = starts[(game / 2) % starts.size()];
+                const bool aIsWhite = game % 2 == 0;
+                GameRecord g = aIsWhite ? playGame(opt, opt.a, opt.b, searchA, searchB, start)
+                                        : playGame(opt, opt.b, opt.a, searchB, searchA, start);
+                g.round = game + 1;
+                g.aIsWhite = aIsWhite;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                const bool draw = g.result == "1/2-1/2";
+                const bool aWins = !draw && (g.result == "1-0") == aIsWhite;
+                draw ? ++score.draws : aWins ? ++score.wins : ++score.losses;
+                writePgn(pgn, g, opt);
+
+                const double llr = sprtLlr(score, opt.elo0, opt.elo1);
+                if (score.games() % 10 == 0 || score.games() == opt.games) std::cout << summarize(score, opt, llr) << "\n";
+                if (opt.sprt && verdict.empty() && (llr >= upperBound || llr <= lowerBound)) {
+                    std::ostringstream os;
+                    os << (llr >= upperBound ? "H1 accepted (Elo >= " : "H0 accepted (Elo <= ")
+                       << (llr >= upperBound ? opt.elo1 : opt.elo0) << ")";
+                    verdict = os.str();
+                    stop = true;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    const std::string summary = summarize(score, opt, sprtLlr(score, opt.elo0, opt.elo1));
+    std::cout << summary << "\n";
+    if (opt.sprt) std::cout << "SPRT: " << (verdict.empty() ? "inconclusive" : verdict) << "\n";
+    std::ofstream(fs::path(opt.outDir) / "summary.txt")
+        << summary << "\n" << (opt.sprt ? "SPRT: " + (verdict.empty() ? std::string("inconclusive") : verdict) + "\n" : "");
+    return 0;
+}
@@ -0,0 +1,461 @@
+// Offline trainer for the neural evaluator (src/Engine/Nnue.hpp). CPU only.
+//
+// 1. Self-play: worker threads play fast fixed-node games with the engine and
+//    append quiet positions to a text file as "fen;score;result", where score
+//    is the search score in centipawns and result the game outcome, both from
+//    White's point of view.
+// 2. Training: a float copy of the network is fitted with Adam to a blend of
+//    the search score and the game result (both squashed to win probability).
+// 3. The weights are quantised to the int16 layout the engine loads and the
+//    quantised network is checked against the float one on held-out positions.
+//
+// Usage:
+//   nnue_trainer [--games N] [--nodes N] [--threads N] [--data FILE]
+//                [--eval-net FILE] [--epochs N] [--lr X] [--lambda X] [--out FILE]
+//
+// A second generation is trained by passing the previous output as --eval-net,
+// so self-play is searched with the network instead of the classical eval.
+
+#include "Engine/Nnue.hpp"
+#include "Engine/Search.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 0;
+    std::uint64_t nodes = 5000;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string data = "nnue_data.txt";
+    std::string evalNet;
+    int epochs = 10;
+    float lr = 0.001f;
+    float lambda = 0.7f;
+    std::string out = "network.bin";
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--games") opt.games = std::stoi(value);
+        else if (arg == "--nodes") opt.nodes = std::stoull(value);
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else if (arg == "--data") opt.data = value;
+        else if (arg == "--eval-net") opt.evalNet = value;
+        else if (arg == "--epochs") opt.epochs = std::stoi(value);
+        else if (arg == "--lr") opt.lr = std::stof(value);
+        else if (arg == "--lambda") opt.lambda = std::stof(value);
+        else if (arg == "--out") opt.out = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- self-play
+
+constexpr int RANDOM_OPENING_PLIES = 8;
+constexpr int MAX_GAME_PLIES = 400;
+constexpr int ADJUDICATE_SCORE = 2500;   // centipawns, for ADJUDICATE_PLIES in a row
+constexpr int ADJUDICATE_PLIES = 6;
+
+struct Sample {
+    std::string fen;
+    int score; // White's point of view
+};
+
+void playGames(const Options& opt, int threadId, std::atomic<int>& nextGame, std::mutex& outMutex,
+               std::ofstream& out, std::atomic<std::uint64_t>& written) {
+    std::mt19937_64 rng(0x9E3779B97F4A7C15ULL * (threadId + 1));
+    auto search = std::make_unique<Search>();
+    SearchLimits limits;
+    limits.nodes = opt.nodes;
+
+    while (nextGame.fetch_add(1) < opt.games) {
+        search->clear();
+        Position pos;
+        pos.setFromFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+        // Random opening so the games differ
+        bool over = false;
+        for (int ply = 0; ply < RANDOM_OPENING_PLIES && !over; ++ply) {
+            MoveList legal;
+            pos.legalMoves(legal);
+            if (legal.size == 0) over = true;
+            else pos.doMove(legal.moves[rng() % legal.size]);
+        }
+        if (over) continue;
+
+        std::vector<Sample> samples;
+        double result = 0.5;
+        int decisiveStreak = 0;
+        for (int ply = 0; ply < MAX_GAME_PLIES; ++ply) {
+            MoveList legal;
+            pos.legalMoves(legal);
+            if (legal.size == 0) {
+                if (pos.inCheck()) result = pos.sideToMove() == Color::WHITE ? 0.0 : 1.0;
+                break;
+            }
+            if (pos.isDraw()) break;
+
+            pos.setGamePly(RANDOM_OPENING_PLIES + ply);
+            SearchResult r = search->think(pos, limits);
+            const int whiteScore = pos.sideToMove() == Color::WHITE ? r.score : -r.score;
+
+            // Only quiet positions: the static eval cannot see tactics in progress
+            if (!pos.inCheck() && !pos.isCapture(r.bestMove) && moveKind(r.bestMove) != MoveKind::PROMOTION &&
+                std::abs(r.score) < VALUE_MATE_IN_MAX_PLY) {
+                samples.push_back({pos.toFen(), whiteScore});
+            }
+
+            decisiveStreak = std::abs(r.score) >= ADJUDICATE_SCORE ? decisiveStreak + 1 : 0;
+            if (decisiveStreak >= ADJUDICATE_PLIES) {
+                result = whiteScore > 0 ? 1.0 : 0.0;
+                break;
+            }
+            pos.doMove(r.bestMove);
+        }
+
+        std::lock_guard<std::mutex> lock(outMutex);
+        for (const Sample& s : samples) out << s.fen << ';' << s.score << ';' << result << '\n';
+        written += samples.size();
+    }
+}
+
+bool generate(const Options& opt) {
+    std::ofstream out(opt.data, std::ios::app);
+    if (!out) {
+        std::cerr << "Cannot open " << opt.data << " for writing\n";
+        return false;
+    }
+    std::atomic<int> nextGame{0};
+    std::atomic<std::uint64_t> written{0};
+    std::mutex outMutex;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; ++t)
+        workers.emplace_back(playGames, std::cref(opt), t, std::ref(nextGame), std::ref(outMutex), std::ref(out), std::ref(written));
+    for (auto& w : workers) w.join();
+
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Self-play: " << opt.games << " games, " << written << " positions in " << secs << " s\n";
+    return true;
+}
+
+// ---------------------------------------------------------------- training
+
+constexpr int MAX_FEATURES = 32;
+constexpr float WEIGHT_CLIP = 1.98f; // keeps quantised values inside int16 / madd range
+constexpr std::size_t QUANTISATION_CHECKS = 1000; // held-out positions the quantised network is compared on
+
+struct TrainingPosition {
+    std::uint16_t us[MAX_FEATURES];    // features seen by the side to move
+    std::uint16_t them[MAX_FEATURES];
+    std::uint8_t count;
+    float target;                      // expected score for the side to move, 0..1
+    std::uint32_t line;                // in the data file, to find the position again
+};
+
+// Positions [0, trainSize) of the shuffled data are trained on, the rest (5%) held out
+std::size_t trainSize(std::size_t positions) { return positions - positions / 20; }
+
+float sigmoid(float x) { return 1.0f / (1.0f + std::exp(-x)); }
+
+void extractFeatures(const Position& pos, TrainingPosition& tp) {
+    const Color stm = pos.sideToMove();
+    tp.count = 0;
+    for (Bitboard occ = pos.pieces(); occ && tp.count < MAX_FEATURES;) {
+        int sq = popLsb(occ);
+        tp.us[tp.count] = static_cast<std::uint16_t>(Nnue::featureIndex(stm, pos.pieceOn(sq), sq));
+        tp.them[tp.count] = static_cast<std::uint16_t>(Nnue::featureIndex(opposite(stm), pos.pieceOn(sq), sq));
+        ++tp.count;
+    }
+}
+
+bool loadData(const Options& opt, std::vector<TrainingPosition>& data) {
+    std::ifstream in(opt.data);
+    if (!in) {
+        std::cerr << "Cannot open " << opt.data << "\n";
+        return false;
+    }
+    std::string line;
+    Position pos;
+    for (std::uint32_t lineNo = 0; std::getline(in, line); ++lineNo) {
+        std::istringstream ss(line);
+        std::string fen, score, result;
+        if (!std::getline(ss, fen, ';') || !std::getline(ss, score, ';') || !std::getline(ss, result)) continue;
+        if (!pos.setFromFen(fen)) continue;
+
+        TrainingPosition tp{};
+        extractFeatures(pos, tp);
+        float s = std::stof(score) / Nnue::OUTPUT_SCALE;
+        float r = std::stof(result);
+        if (pos.sideToMove() == Color::BLACK) {
+            s = -s;
+            r = 1.0f - r;
+        }
+        tp.target = opt.lambda * sigmoid(s) + (1.0f - opt.lambda) * r;
+        tp.line = lineNo;
+        data.push_back(tp);
+    }
+    return true;
+}
+
+struct FloatNet {
+    std::vector<float> w1 = std::vector<float>(Nnue::INPUTS * Nnue::HIDDEN);
+    std::vector<float> b1 = std::vector<float>(Nnue::HIDDEN);
+    std::vector<float> w2 = std::vector<float>(2 * Nnue::HIDDEN);
+    float b2 = 0.0f;
+
+    void zero() {
+        std::fill(w1.begin(), w1.end(), 0.0f);
+        std::fill(b1.begin(), b1.end(), 0.0f);
+        std::fill(w2.begin(), w2.end(), 0.0f);
+        b2 = 0.0f;
+    }
+};
+
+// Forward pass; fills the hidden pre-activations and returns the output logit
+float forward(const FloatNet& net, const TrainingPosition& tp, float* hUs, float* hThem) {
+    constexpr int H = Nnue::HIDDEN;
+    std::copy(net.b1.begin(), net.b1.end(), hUs);
+    std::copy(net.b1.begin(), net.b1.end(), hThem);
+    for (int f = 0; f < tp.count; ++f) {
+        const float* cu = &net.w1[tp.us[f] * H];
+        const float* ct = &net.w1[tp.them[f] * H];
+        for (int j = 0; j < H; ++j) {
+            hUs[j] += cu[j];
+            hThem[j] += ct[j];
+        }
+    }
+    float out = net.b2;
+    for (int j = 0; j < H; ++j) {
+        out += std::clamp(hUs[j], 0.0f, 1.0f) * net.w2[j];
+        out += std::clamp(hThem[j], 0.0f, 1.0f) * net.w2[H + j];
+    }
+    return out;
+}
+
+// Accumulates the gradient of the squared error for [begin, end) into grad; returns the summed loss
+double backward(const FloatNet& net, const std::vector<TrainingPosition>& data, const std::vector<std::size_t>& order,
+                std::size_t begin, std::size_t end, FloatNet& grad) {
+    constexpr int H = Nnue::HIDDEN;
+    float hUs[H], hThem[H], dUs[H], dThem[H];
+    double loss = 0.0;
+    for (std::size_t i = begin; i < end; ++i) {
+        const TrainingPosition& tp = data[order[i]];
+        const float p = sigmoid(forward(net, tp, hUs, hThem));
+        const float err = p - tp.target;
+        loss += err * err;
+        const float dOut = 2.0f * err * p * (1.0f - p);
+
+        grad.b2 += dOut;
+        for (int j = 0; j < H; ++j) {
+            const float aUs = std::clamp(hUs[j], 0.0f, 1.0f);
+            const float aThem = std::clamp(hThem[j], 0.0f, 1.0f);
+            grad.w2[j] += dOut * aUs;
+            grad.w2[H + j] += dOut * aThem;
+            dUs[j] = (hUs[j] > 0.0f && hUs[j] < 1.0f) ? dOut * net.w2[j] : 0.0f;
+            dThem[j] = (hThem[j] > 0.0f && hThem[j] < 1.0f) ? dOut * net.w2[H + j] : 0.0f;
+            grad.b1[j] += dUs[j] + dThem[j];
+        }
+        for (int f = 0; f < tp.count; ++f) {
+            float* gu = &grad.w1[tp.us[f] * H];
+            float* gt = &grad.w1[tp.them[f] * H];
+            for (int j = 0; j < H; ++j) {
+                gu[j] += dUs[j];
+                gt[j] += dThem[j];
+            }
+        }
+    }
+    return loss;
+}
+
+struct Adam {
+    FloatNet m, v;
+    float mb2 = 0.0f, vb2 = 0.0f;
+    int step = 0;
+
+    Adam() {
+        m.zero();
+        v.zero();
+    }
+
+    static void update(std::vector<float>& w, const std::vector<float>& g, std::vector<float>& m, std::vector<float>& v,
+                       float lr, float c1, float c2, float scale) {
+        for (std::size_t i = 0; i < w.size(); ++i) {
+            const float gi = g[i] * scale;
+            m[i] = 0.9f * m[i] + 0.1f * gi;
+            v[i] = 0.999f * v[i] + 0.001f * gi * gi;
+            w[i] -= lr * (m[i] / c1) / (std::sqrt(v[i] / c2) + 1e-8f);
+            w[i] = std::clamp(w[i], -WEIGHT_CLIP, WEIGHT_CLIP);
+        }
+    }
+
+    void apply(FloatNet& net, const FloatNet& grad, float lr, std::size_t batchSize) {
+        ++step;
+        const float c1 = 1.0f - std::pow(0.9f, static_cast<float>(step));
+        const float c2 = 1.0f - std::pow(0.999f, static_cast<float>(step));
+        const float scale = 1.0f / static_cast<float>(batchSize);
+        update(net.w1, grad.w1, m.w1, v.w1, lr, c1, c2, scale);
+        update(net.b1, grad.b1, m.b1, v.b1, lr, c1, c2, scale);
+        update(net.w2, grad.w2, m.w2, v.w2, lr, c1, c2, scale);
+        const float gb = grad.b2 * scale;
+        mb2 = 0.9f * mb2 + 0.1f * gb;
+        vb2 = 0.999f * vb2 + 0.001f * gb * gb;
+        net.b2 -= lr * (mb2 / c1) / (std::sqrt(vb2 / c2) + 1e-8f);
+    }
+};
+
+double validationLoss(const FloatNet& net, const std::vector<TrainingPosition>& data, std::size_t begin) {
+    float hUs[Nnue::HIDDEN], hThem[Nnue::HIDDEN];
+    double loss = 0.0;
+    for (std::size_t i = begin; i < data.size(); ++i) {
+        float err = sigmoid(forward(net, data[i], hUs, hThem)) - data[i].target;
+        loss += err * err;
+    }
+    return data.size() > begin ? loss / (data.size() - begin) : 0.0;
+}
+
+void train(const Options& opt, std::vector<TrainingPosition>& data, FloatNet& net) {
+    constexpr std::size_t BATCH = 16384;
+    std::mt19937 rng(12345);
+    std::shuffle(data.begin(), data.end(), rng);
+    const std::size_t trainEnd = trainSize(data.size());
+
+    std::uniform_real_distribution<float> init(-0.05f, 0.05f);
+    for (float& w : net.w1) w = init(rng);
+    for (float& w : net.w2) w = init(rng);
+
+    std::vector<std::size_t> order(trainEnd);
+    for (std::size_t i = 0; i < trainEnd; ++i) order[i] = i;
+
+    Adam adam;
+    std::vector<FloatNet> grads(opt.threads);
+    for (int epoch = 1; epoch <= opt.epochs; ++epoch) {
+        // Drop the learning rate for the final quarter of the run
+        const float lr = epoch > opt.epochs * 3 / 4 ? opt.lr * 0.1f : opt.lr;
+        std::shuffle(order.begin(), order.end(), rng);
+        double trainLoss = 0.0;
+
+        for (std::size_t start = 0; start < trainEnd; start += BATCH) {
+            const std::size_t end = std::min(trainEnd, start + BATCH);
+            const std::size_t chunk = (end - start + opt.threads - 1) / opt.threads;
+            std::vector<double> losses(opt.threads, 0.0);
+            std::vector<std::thread> workers;
+            for (int t = 0; t < opt.threads; ++t) {
+                const std::size_t b = std::min(end, start + t * chunk), e = std::min(end, b + chunk);
+                workers.emplace_back([&, t, b, e] {
+                    grads[t].zero();
+                    losses[t] = backward(net, data, order, b, e, grads[t]);
+                });
+            }
+            for (auto& w : workers) w.join();
+            for (int t = 1; t < opt.threads; ++t) {
+                for (std::size_t i = 0; i < net.w1.size(); ++i) grads[0].w1[i] += grads[t].w1[i];
+                for (std::size_t i = 0; i < net.b1.size(); ++i) grads[0].b1[i] += grads[t].b1[i];
+                for (std::size_t i = 0; i < net.w2.size(); ++i) grads[0].w2[i] += grads[t].w2[i];
+                grads[0].b2 += grads[t].b2;
+            }
+            for (double l : losses) trainLoss += l;
+            adam.apply(net, grads[0], lr, end - start);
+        }
+        std::cout << "Epoch " << epoch << ": train loss " << trainLoss / trainEnd
+                  << ", validation loss " << validationLoss(net, data, trainEnd) << "\n";
+    }
+}
+
+std::int16_t quantise(float w, int scale) {
+    return static_cast<std::int16_t>(std::lround(w * scale));
+}
+
+void quantiseNetwork(const FloatNet& net, Nnue::Network& q) {
+    for (std::size_t i = 0; i < net.w1.size(); ++i) q.featureWeights[i] = quantise(net.w1[i], Nnue::QA);
+    for (int j = 0; j < Nnue::HIDDEN; ++j) q.featureBias[j] = quantise(net.b1[j], Nnue::QA);
+    for (int j = 0; j < 2 * Nnue::HIDDEN; ++j) q.outputWeights[j] = quantise(net.w2[j], Nnue::QB);
+    q.outputBias = static_cast<std::int32_t>(std::lround(net.b2 * Nnue::QA * Nnue::QB));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+
+    if (!opt.evalNet.empty()) {
+        if (!Nnue::load(opt.evalNet)) {
+            std::cerr << "Cannot load network " << opt.evalNet << "\n";
+            return 1;
+        }
+        std::cout << "Self-play uses network " << opt.evalNet << "\n";
+    }
+    if (opt.games > 0 && !generate(opt)) return 1;
+
+    std::vector<TrainingPosition> data;
+    if (!loadData(opt, data)) return 1;
+    if (data.size() < 1000) {
+        std::cerr << "Only " << data.size() << " positions in " << opt.data << "; generate more with --games\n";
+        return 1;
+    }
+    std::cout << "Training on " << data.size() << " positions\n";
+
+    FloatNet net;
+    train(opt, data, net);
+
+    auto quantised = std::make_unique<Nnue::Network>();
+    quantiseNetwork(net, *quantised);
+    if (!Nnue::save(*quantised, opt.out)) {
+        std::cerr << "Cannot write " << opt.out << "\n";
+        return 1;
+    }
+
+    // Compare the engine's integer evaluation with the float network on the held-out
+    // positions; the integer path needs a Position, so they are read again from the file
+    std::vector<std::uint32_t> heldOut;
+    for (std::size_t i = trainSize(data.size()); i < data.size() && heldOut.size() < QUANTISATION_CHECKS; ++i) {
+        heldOut.push_back(data[i].line);
+    }
+    std::sort(heldOut.begin(), heldOut.end());
+
+    Nnue::setNetwork(*quantised);
+    std::ifstream in(opt.data);
+    std::string line;
+    Position pos;
+    double diff = 0.0;
+    int checked = 0;
+    float hUs[Nnue::HIDDEN], hThem[Nnue::HIDDEN];
+    auto next = heldOut.begin();
+    for (std::uint32_t lineNo = 0; next != heldOut.end() && std::getline(in, line); ++lineNo) {
+        if (lineNo != *next) continue;
+        ++next;
+        if (!pos.setFromFen(line.substr(0, line.find(';')))) continue;
+        TrainingPosition tp{};
+        extractFeatures(pos, tp);
+        diff += std::abs(forward(net, tp, hUs, hThem) * Nnue::OUTPUT_SCALE - Nnue::evaluate(pos.accumulator(), pos.sideToMove()));
+        ++checked;
+    }
+    std::cout << "Wrote " << opt.out << " (mean quantisation error " << (checked ? diff / checked : 0.0)
+              << " cp over " << checked << " held-out positions)\n";
+    return 0;
+}
@@ -0,0 +1,223 @@
+// Extracts tactical puzzles from the games GameRecorder saves in recent_games/.
+//
+// Every archived game (GameArchive.hpp) is replayed and each position is searched
+// with two lines (multi-PV). A position becomes a puzzle when exactly one move
+// wins: the best line scores at least --win centipawns (or mates) for the side to
+// move while the second best stays at or below --second. By default only tactics
+// the player missed are kept (the move played in the game was a different one);
+// --all keeps the ones that were found too. Every candidate is searched again
+// with --verify-nodes before it is accepted, so shallow mirages are dropped.
+//
+// Puzzles are written as EPD lines, one per puzzle, readable by epd_runner:
+//
+//   <FEN> bm <SAN>; pv <solution in SAN>; ce <cp> | dm <mate in N>; id "<game>:<ply>";
+//
+// Games are processed by a pool of threads. After each game its puzzles are
+// appended to the output and the game is listed in <out>.done; an interrupted run
+// started again with the same --out skips the games listed there.
+//
+// Usage:
+//   puzzle_extractor [--games-dir DIR] [--out FILE] [--nodes N] [--verify-nodes N]
+//                    [--win CP] [--second CP] [--min-ply N] [--threads N] [--all]
+
+#include "Engine/GameArchive.hpp"
+#include "Engine/Search.hpp"
+#include "Engine/Tablebase.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Length of the stored solution line in plies (the solver's moves and the replies)
+constexpr int SOLUTION_PLIES = 5;
+
+struct Options {
+    std::string gamesDir = "../recent_games";
+    std::string out = "puzzles.epd";
+    std::uint64_t nodes = 200000;
+    std::uint64_t verifyNodes = 1000000;
+    int win = 250;          // best line must score at least this
+    int second = 80;        // ... and the second best at most this
+    int minPly = 6;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    bool all = false;
+    std::string tablebases = "../assets/tablebases";
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--all") {
+            opt.all = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--games-dir") opt.gamesDir = value;
+        else if (arg == "--out") opt.out = value;
+        else if (arg == "--nodes") opt.nodes = std::stoull(value);
+        else if (arg == "--verify-nodes") opt.verifyNodes = std::stoull(value);
+        else if (arg == "--win") opt.win = std::stoi(value);
+        else if (arg == "--second") opt.second = std::stoi(value);
+        else if (arg == "--min-ply") opt.minPly = std::max(0, std::stoi(value));
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else if (arg == "--tablebases") opt.tablebases = value;
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.second >= opt.win) {
+        std::cerr << "--second must be below --win\n";
+        return false;
+    }
+    return true;
+}
+
+bool isMate(int score) { return std::abs(score) >= VALUE_MATE_IN_MAX_PLY; }
+
+// Exactly one move wins: the best line clears the bar and the second does not
+// come near it (a second mate or winning line means several solutions)
+bool uniqueWin(const SearchResult& r, const Options& opt) {
+    if (r.lines.size() < 2) return false; // forced or only move: nothing to find
+    const int best = r.lines[0].score, second = r.lines[1].score;
+    return (isMate(best) ? best > 0 : best >= opt.win) && !isMate(second) && second <= opt.second;
+}
+
+std::string epdLine(const Position& pos, const SearchLine& line, const std::string& id) {
+    // First four FEN fields: EPD has no move counters
+    std::istringstream fen(pos.toFen());
+    std::string board, side, castling, ep;
+    fen >> board >> side >> castling >> ep;
+
+    std::ostringstream os;
+    os << board << " " << side << " " << castling << " " << ep << " bm " << pos.toSan(line.move) << "; pv";
+    Position p = pos;
+    for (std::size_t i = 0; i < line.pv.size() && i < static_cast<std::size_t>(SOLUTION_PLIES); ++i) {
+        os << " " << p.toSan(line.pv[i]);
+        p.doMove(line.pv[i]);
+    }
+    if (isMate(line.score)) os << "; dm " << (VALUE_MATE - line.score + 1) / 2;
+    else os << "; ce " << line.score;
+    os << "; id \"" << id << "\";";
+    return os.str();
+}
+
+// Puzzles of one game, as EPD lines
+std::vector<std::string> extractGame(const fs::path& file, const std::string& variant, const Options& opt,
+                                     Search& search) {
+    std::vector<std::string> puzzles;
+    ArchivedGame game;
+    Position pos;
+    if (!readArchivedGame(file, game) || !archivedStartPosition(variant, game, pos)) return puzzles;
+    search.clear();
+
+    SearchLimits scan;
+    scan.nodes = opt.nodes;
+    scan.multiPv = 2;
+    SearchLimits verify = scan;
+    verify.nodes = opt.verifyNodes;
+
+    for (int ply = 0; ply < static_cast<int>(game.moves.size()); ++ply) {
+        const EngineMove played = parseRecordedMove(pos, game.moves[ply]);
+        if (played == NO_MOVE) break; // ambiguous or illegal record: the rest cannot be replayed
+
+        if (ply >= opt.minPly) {
+            const SearchResult r = search.think(pos, scan);
+            if (uniqueWin(r, opt) && (opt.all || played != r.bestMove)) {
+                const SearchResult deep = search.think(pos, verify);
+                if (uniqueWin(deep, opt) && deep.bestMove == r.bestMove && (opt.all || played != deep.bestMove)) {
+                    puzzles.push_back(epdLine(pos, deep.lines[0], file.stem().string() + ":" + std::to_string(ply + 1)));
+                }
+            }
+        }
+        pos.doMove(played);
+    }
+    return puzzles;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+    if (!fs::is_directory(opt.gamesDir)) {
+        std::cerr << "No games directory " << opt.gamesDir << "\n";
+        return 1;
+    }
+    Tablebase::init(opt.tablebases);
+
+    // Games finished by an earlier run
+    const std::string donePath = opt.out + ".done";
+    std::set<std::string> done;
+    {
+        std::ifstream in(donePath);
+        for (std::string line; std::getline(in, line);) done.insert(line);
+    }
+
+    struct Job {
+        fs::path file;
+        std::string variant;
+    };
+    std::vector<Job> jobs;
+    for (const auto& [variant, files] : listArchive(opt.gamesDir)) {
+        for (const fs::path& file : files) {
+            if (!done.count(file.string())) jobs.push_back({file, variant});
+        }
+    }
+    std::cout << jobs.size() << " games to scan";
+    if (!done.empty()) std::cout << " (" << done.size() << " done earlier)";
+    std::cout << "\n";
+
+    std::ofstream out(opt.out, std::ios::app);
+    std::ofstream doneOut(donePath, std::ios::app);
+    if (!out || !doneOut) {
+        std::cerr << "Cannot write " << opt.out << "\n";
+        return 1;
+    }
+
+    std::mutex mutex; // guards the output files, counters and the console
+    std::atomic<std::size_t> next{0};
+    std::size_t finished = 0, found = 0;
+    std::vector<std::thread> workers;
+    const int threads = std::min<int>(opt.threads, std::max<int>(1, static_cast<int>(jobs.size())));
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            Search search;
+            std::size_t i;
+            while ((i = next.fetch_add(1)) < jobs.size()) {
+                const std::vector<std::string> puzzles = extractGame(jobs[i].file, jobs[i].variant, opt, search);
+
+                // Puzzles before the done mark: a crash in between repeats a game, never loses one
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const std::string& p : puzzles) out << p << "\n";
+                out.flush();
+                doneOut << jobs[i].file.string() << "\n";
+                doneOut.flush();
+                ++finished;
+                found += puzzles.size();
+                std::cout << "[" << finished << "/" << jobs.size() << "] " << jobs[i].file.filename().string() << ": "
+                          << puzzles.size() << " puzzles (" << found << " total)\n";
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    std::cout << found << " puzzles from " << finished << " games -> " << opt.out << "\n";
+    return 0;
+}
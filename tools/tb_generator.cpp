@@ -0,0 +1,678 @@
+// Generates endgame tablebases (src/Engine/Tablebase.hpp) by retrograde analysis.
+//
+// Tables needed by captures and promotions are generated first, so asking for
+// "KRPvKR" also builds KRPvK, KRvKR, KQRvKR, ... down to three pieces. Every
+// table is written straight into a memory-mapped <dir>/<signature>.tb:
+//
+//   init       mark illegal placements, mates, stalemates, and resolve moves
+//              that leave the table (captures, promotions) from the smaller tables
+//   level k    positions lost in k-1 moves make their predecessors won in k;
+//              predecessors of positions won in k are lost once every move wins
+//              for the opponent (k = 1, 2, ... until nothing is left to resolve)
+//   verify     every stored value is checked against the values of its children
+//
+// Predecessors are found by un-moving the side that just moved; each pass
+// scans the table in parallel, collects candidates in a bitmap and
+// re-examines them with forward move generation, so duplicates are harmless.
+// A position whose longest resistance is a capture or promotion has no
+// predecessor inside the table at that level, so after init it is queued
+// directly for the level of its slowest losing exit. Whatever is still
+// unresolved at the end is a draw.
+//
+// The file header records the next level to run and pages are flushed after
+// every level, so an interrupted run picks up where it stopped.
+//
+// Usage:
+//   tb_generator --tables KQvK,KRvK,KBNvK [--dir DIR] [--threads N]
+
+#include "Engine/Tablebase.hpp"
+#include "Engine/MappedFile.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Bitboards;
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    std::vector<std::string> tables;
+    std::string dir = "../assets/tablebases";
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+};
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << "\n";
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--tables") {
+            std::stringstream ss(value);
+            for (std::string sig; std::getline(ss, sig, ',');) {
+                if (!sig.empty()) opt.tables.push_back(sig);
+            }
+        } else if (arg == "--dir") opt.dir = value;
+        else if (arg == "--threads") opt.threads = std::max(1, std::stoi(value));
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return false;
+        }
+    }
+    if (opt.tables.empty()) {
+        std::cerr << "Usage: tb_generator --tables KQvK,KRvK [--dir DIR] [--threads N]\n";
+        return false;
+    }
+    return true;
+}
+
+constexpr PieceType PROMOTIONS[4] = {PieceType::QUEEN, PieceType::ROOK, PieceType::BISHOP, PieceType::KNIGHT};
+
+// Signature of a table after removing slot `removed` and/or promoting slot `promoted`
+std::string childSignature(const TbLayout& layout, int removed, int promoted, PieceType promo, bool& swapped) {
+    int pieces[TB_MAX_PIECES];
+    int n = 0;
+    for (int i = 0; i < layout.pieceCount(); ++i) {
+        if (i == removed) continue;
+        pieces[n++] = i == promoted ? makePiece(pieceColor(layout.piece(i)), promo) : layout.piece(i);
+    }
+    return tbSignature(pieces, n, swapped);
+}
+
+// A move leaving the table being built: lookup into a smaller (or promoted) table.
+// slot[i] maps a slot of the current table to the child table's slot.
+struct Exit {
+    bool draw = false;              // bare kings
+    const TbLayout* layout = nullptr;
+    const std::uint8_t* values = nullptr;
+    bool swapped = false;
+    int slot[TB_MAX_PIECES] = {};
+};
+
+// Everything needed to generate one table
+class Generator {
+public:
+    Generator(const TbLayout& layout, std::uint8_t* values, int threads)
+        : layout_(layout), values_(values), threads_(threads),
+          words_((layout.size() + 63) / 64), candidates_(new std::atomic<std::uint64_t>[words_]) {}
+
+    bool prepareExits();
+    void initialise();
+    // Queue unresolved positions whose moves out of the table all lose (after
+    // init, and again when resuming). Returns the highest queued level.
+    int queueExitLosses();
+    // Runs one level; returns the number of positions resolved
+    std::uint64_t level(int k);
+    int highestPendingLevel();
+    // Positions whose value disagrees with their children
+    std::uint64_t verify();
+
+private:
+    struct Placement {
+        int sq[TB_MAX_PIECES];
+        Color stm;
+    };
+
+    // Outcome of the moves of one position, from the mover's side
+    struct Children {
+        int moves = 0;
+        int minLoss = -1;       // quickest child lost for the opponent
+        int maxWin = 0;         // slowest child won by the opponent
+        bool allWins = true;    // every child is won by the opponent
+        int inTable = 0;        // moves staying in the table, not visited when exitsOnly
+    };
+
+    std::uint8_t load(std::uint64_t idx) const { return __atomic_load_n(values_ + idx, __ATOMIC_RELAXED); }
+    void store(std::uint64_t idx, std::uint8_t v) { __atomic_store_n(values_ + idx, v, __ATOMIC_RELAXED); }
+    void markCandidate(std::uint64_t idx) {
+        candidates_[idx >> 6].fetch_or(std::uint64_t(1) << (idx & 63), std::memory_order_relaxed);
+    }
+
+    Exit& exitFor(int removed, int promoted, int promo) { return exits_[removed + 1][promoted + 1][promo]; }
+    const Exit& exitFor(int removed, int promoted, int promo) const { return exits_[removed + 1][promoted + 1][promo]; }
+    Bitboard occupancy(const Placement& p, int skip) const;
+    bool attacked(const Placement& p, int sq, Color by, int skip) const;
+    bool isValid(const Placement& p) const;
+    std::uint8_t exitValue(const Exit& e, const Placement& p) const;
+    void children(const Placement& p, bool exitsOnly, Children& out) const;
+    void markPredecessors(const Placement& p);
+    void update(std::uint64_t idx, int k);
+    std::uint8_t expected(const Placement& p, const Children& c) const;
+
+    // Run fn(begin, end) over [0, size) in chunks on all threads
+    void parallel(std::uint64_t size, const std::function<void(std::uint64_t, std::uint64_t)>& fn) const;
+
+    const TbLayout& layout_;
+    std::uint8_t* values_;
+    int threads_;
+    std::uint64_t words_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> candidates_;
+    Exit exits_[TB_MAX_PIECES + 1][TB_MAX_PIECES + 1][4];
+    std::vector<std::vector<std::uint64_t>> exitLosses_; // by level, see queueExitLosses()
+};
+
+void Generator::parallel(std::uint64_t size, const std::function<void(std::uint64_t, std::uint64_t)>& fn) const {
+    constexpr std::uint64_t CHUNK = 1 << 16;
+    std::atomic<std::uint64_t> next{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads_; ++t) {
+        workers.emplace_back([&] {
+            std::uint64_t begin;
+            while ((begin = next.fetch_add(CHUNK)) < size) fn(begin, std::min(begin + CHUNK, size));
+        });
+    }
+    for (auto& w : workers) w.join();
+}
+
+bool Generator::prepareExits() {
+    for (int removed = -1; removed < layout_.pieceCount(); ++removed) {
+        if (removed == 0 || removed == 1) continue; // kings are never captured
+        for (int promoted = -1; promoted < layout_.pieceCount(); ++promoted) {
+            if (promoted == removed) continue;
+            if (promoted >= 0 && pieceType(layout_.piece(promoted)) != PieceType::PAWN) continue;
+            if (removed < 0 && promoted < 0) continue;
+            for (int promo = 0; promo < (promoted >= 0 ? 4 : 1); ++promo) {
+                Exit& e = exitFor(removed, promoted, promo);
+                if (layout_.pieceCount() - (removed >= 0) == 2) {
+                    e.draw = true;
+                    continue;
+                }
+                const std::string sig = childSignature(layout_, removed, promoted, PROMOTIONS[promo], e.swapped);
+                if (!Tablebase::find(sig, e.layout, e.values)) {
+                    std::cerr << layout_.signature() << ": missing table " << sig << "\n";
+                    return false;
+                }
+                // Match slots by piece code, seen from the child table's strong side
+                bool used[TB_MAX_PIECES] = {};
+                for (int i = 0; i < layout_.pieceCount(); ++i) {
+                    e.slot[i] = -1;
+                    if (i == removed) continue;
+                    int pc = i == promoted ? makePiece(pieceColor(layout_.piece(i)), PROMOTIONS[promo]) : layout_.piece(i);
+                    if (e.swapped) pc = makePiece(opposite(pieceColor(pc)), pieceType(pc));
+                    for (int s = 0; s < e.layout->pieceCount(); ++s) {
+                        if (!used[s] && e.layout->piece(s) == pc) {
+                            used[s] = true;
+                            e.slot[i] = s;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+Bitboard Generator::occupancy(const Placement& p, int skip) const {
+    Bitboard occ = 0;
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        if (i != skip) occ |= squareBB(p.sq[i]);
+    }
+    return occ;
+}
+
+// Is sq attacked by `by`, ignoring the piece in slot skip (just captured)?
+bool Generator::attacked(const Placement& p, int sq, Color by, int skip) const {
+    const Bitboard occ = occupancy(p, skip);
+    const Bitboard target = squareBB(sq);
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        if (i == skip || pieceColor(layout_.piece(i)) != by) continue;
+        const int from = p.sq[i];
+        Bitboard att = 0;
+        switch (pieceType(layout_.piece(i))) {
+            case PieceType::KING: att = kingAttacks(from); break;
+            case PieceType::QUEEN: att = rookAttacks(from, occ) | bishopAttacks(from, occ); break;
+            case PieceType::ROOK: att = rookAttacks(from, occ); break;
+            case PieceType::BISHOP: att = bishopAttacks(from, occ); break;
+            case PieceType::KNIGHT: att = knightAttacks(from); break;
+            default: att = pawnAttacks(by, from); break;
+        }
+        if (att & target) return true;
+    }
+    return false;
+}
+
+bool Generator::isValid(const Placement& p) const {
+    if (popCount(occupancy(p, -1)) != layout_.pieceCount()) return false;
+    // The side that just moved cannot be in check (this also keeps the kings apart)
+    const Color them = opposite(p.stm);
+    return !attacked(p, p.sq[them == Color::WHITE ? 0 : 1], p.stm, -1);
+}
+
+std::uint8_t Generator::exitValue(const Exit& e, const Placement& p) const {
+    if (e.draw) return TB_DRAW;
+    int squares[TB_MAX_PIECES];
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        if (e.slot[i] >= 0) squares[e.slot[i]] = e.swapped ? flipRow(p.sq[i]) : p.sq[i];
+    }
+    std::uint64_t idx;
+    e.layout->index(squares, e.swapped ? opposite(p.stm) : p.stm, idx);
+    return e.values[idx];
+}
+
+void Generator::children(const Placement& p, bool exitsOnly, Children& out) const {
+    const Color us = p.stm;
+    const Color them = opposite(us);
+    const int kingSlot = us == Color::WHITE ? 0 : 1;
+    Bitboard own = 0, enemy = 0;
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        (pieceColor(layout_.piece(i)) == us ? own : enemy) |= squareBB(p.sq[i]);
+    }
+    const Bitboard occ = own | enemy;
+
+    auto visit = [&](std::uint8_t v) {
+        ++out.moves;
+        if (tbIsLoss(v)) {
+            const int l = v - TB_LOSS_BASE;
+            if (out.minLoss < 0 || l < out.minLoss) out.minLoss = l;
+            out.allWins = false;
+        } else if (tbIsWin(v)) {
+            out.maxWin = std::max<int>(out.maxWin, v);
+        } else {
+            out.allWins = false; // draw, or not resolved yet
+        }
+    };
+
+    Placement child = p;
+    child.stm = them;
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        const int pc = layout_.piece(i);
+        if (pieceColor(pc) != us) continue;
+        const int from = p.sq[i];
+        const PieceType type = pieceType(pc);
+
+        Bitboard targets;
+        switch (type) {
+            case PieceType::KING: targets = kingAttacks(from); break;
+            case PieceType::QUEEN: targets = rookAttacks(from, occ) | bishopAttacks(from, occ); break;
+            case PieceType::ROOK: targets = rookAttacks(from, occ); break;
+            case PieceType::BISHOP: targets = bishopAttacks(from, occ); break;
+            case PieceType::KNIGHT: targets = knightAttacks(from); break;
+            default: {
+                const int push = us == Color::WHITE ? from - 8 : from + 8;
+                targets = pawnAttacks(us, from) & enemy;
+                if (!(occ & squareBB(push))) {
+                    targets |= squareBB(push);
+                    const int startRow = us == Color::WHITE ? 6 : 1;
+                    const int twice = us == Color::WHITE ? from - 16 : from + 16;
+                    if (rowOf(from) == startRow && !(occ & squareBB(twice))) targets |= squareBB(twice);
+                }
+                break;
+            }
+        }
+        targets &= ~own;
+
+        for (Bitboard b = targets; b;) {
+            const int to = popLsb(b);
+            int captured = -1;
+            if (enemy & squareBB(to)) {
+                for (int j = 0; j < layout_.pieceCount(); ++j) {
+                    if (p.sq[j] == to) captured = j;
+                }
+            }
+            child.sq[i] = to;
+            const bool legal = !attacked(child, child.sq[kingSlot], them, captured);
+            if (legal) {
+                const bool promotion = type == PieceType::PAWN && (rowOf(to) == 0 || rowOf(to) == 7);
+                if (promotion) {
+                    for (int promo = 0; promo < 4; ++promo) visit(exitValue(exitFor(captured, i, promo), child));
+                } else if (captured >= 0) {
+                    visit(exitValue(exitFor(captured, -1, 0), child));
+                } else if (exitsOnly) {
+                    ++out.inTable;
+                } else {
+                    std::uint64_t idx;
+                    layout_.index(child.sq, them, idx);
+                    visit(load(idx));
+                }
+            }
+            child.sq[i] = from;
+        }
+    }
+}
+
+void Generator::initialise() {
+    parallel(layout_.size(), [&](std::uint64_t begin, std::uint64_t end) {
+        Placement p;
+        for (std::uint64_t idx = begin; idx < end; ++idx) {
+            layout_.decode(idx, p.sq, p.stm);
+            std::uint64_t canonical;
+            if (!isValid(p) || !layout_.index(p.sq, p.stm, canonical) || canonical != idx) {
+                store(idx, TB_INVALID);
+                continue;
+            }
+
+            // Only moves into smaller tables are known yet; a win found this way may
+            // still get shorter once the in-table moves are resolved
+            Children c;
+            children(p, true, c);
+            const bool inCheck = attacked(p, p.sq[p.stm == Color::WHITE ? 0 : 1], opposite(p.stm), -1);
+            std::uint8_t v = TB_DRAW;
+            if (c.moves + c.inTable == 0) v = inCheck ? tbLoss(0) : TB_DRAW;
+            else if (c.minLoss >= 0) v = tbWin(c.minLoss + 1);
+            else if (c.allWins && c.inTable == 0) v = tbLoss(c.maxWin);
+            store(idx, v);
+        }
+    });
+}
+
+int Generator::queueExitLosses() {
+    exitLosses_.assign(TB_MAX_DTM + 2, {});
+    std::mutex mutex;
+    int highest = 0;
+    parallel(layout_.size(), [&](std::uint64_t begin, std::uint64_t end) {
+        std::vector<std::pair<int, std::uint64_t>> found;
+        Placement p;
+        for (std::uint64_t idx = begin; idx < end; ++idx) {
+            if (load(idx) != TB_DRAW) continue;
+            layout_.decode(idx, p.sq, p.stm);
+            Children c;
+            children(p, true, c);
+            // Lost at the level of the slowest exit unless a move inside the table
+            // draws or resists longer; the in-table case is found through predecessors
+            if (c.inTable > 0 && c.moves > 0 && c.allWins) found.emplace_back(c.maxWin, idx);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [k, idx] : found) {
+            exitLosses_[k].push_back(idx);
+            highest = std::max(highest, k);
+        }
+    });
+    return highest;
+}
+
+void Generator::markPredecessors(const Placement& p) {
+    // Un-move a piece of the side that made the last move (no un-captures, no un-promotions:
+    // those predecessors live in other tables)
+    const Color mover = opposite(p.stm);
+    const Bitboard occ = occupancy(p, -1);
+    Placement prev = p;
+    prev.stm = mover;
+    for (int i = 0; i < layout_.pieceCount(); ++i) {
+        const int pc = layout_.piece(i);
+        if (pieceColor(pc) != mover) continue;
+        const int to = p.sq[i];
+
+        Bitboard sources;
+        switch (pieceType(pc)) {
+            case PieceType::KING: sources = kingAttacks(to); break;
+            case PieceType::QUEEN: sources = rookAttacks(to, occ) | bishopAttacks(to, occ); break;
+            case PieceType::ROOK: sources = rookAttacks(to, occ); break;
+            case PieceType::BISHOP: sources = bishopAttacks(to, occ); break;
+            case PieceType::KNIGHT: sources = knightAttacks(to); break;
+            default: {
+                const int back = mover == Color::WHITE ? 8 : -8;
+                sources = 0;
+                const int once = to + back;
+                if (once >= 8 && once < 56 && !(occ & squareBB(once))) {
+                    sources |= squareBB(once);
+                    const int landRow = mover == Color::WHITE ? 4 : 3;
+                    if (rowOf(to) == landRow && !(occ & squareBB(once + back))) sources |= squareBB(once + back);
+                }
+                break;
+            }
+        }
+        sources &= ~occ;
+
+        for (Bitboard b = sources; b;) {
+            prev.sq[i] = popLsb(b);
+            std::uint64_t idx;
+            if (layout_.index(prev.sq, mover, idx)) markCandidate(idx);
+        }
+        prev.sq[i] = to;
+    }
+}
+
+// Resolve a candidate at level k. Only values up to k are final at this point, so a
+// win needs a child lost in at most k-1 and a loss needs every child won in at most k;
+// anything longer is picked up again at its own level. This keeps every stored
+// distance exact whatever order the threads visit the candidates in.
+void Generator::update(std::uint64_t idx, int k) {
+    const std::uint8_t cur = load(idx);
+    if (cur == TB_INVALID || tbIsLoss(cur)) return;
+
+    Placement p;
+    layout_.decode(idx, p.sq, p.stm);
+    Children c;
+    children(p, false, c);
+    if (c.minLoss >= 0 && c.minLoss < k) {
+        // Also shortens wins found through captures or promotions during init
+        const std::uint8_t v = tbWin(c.minLoss + 1);
+        if (cur == TB_DRAW || v < cur) store(idx, v);
+    } else if (cur == TB_DRAW && c.moves > 0 && c.allWins && c.maxWin <= k) {
+        store(idx, tbLoss(c.maxWin));
+    }
+}
+
+std::uint64_t Generator::level(int k) {
+    std::atomic<std::uint64_t> resolved{0};
+
+    // One scan: candidates are the predecessors of positions holding `trigger`,
+    // plus the queued positions of this level
+    auto pass = [&](std::uint8_t trigger, const std::vector<std::uint64_t>* queued) {
+        for (std::uint64_t w = 0; w < words_; ++w) candidates_[w].store(0, std::memory_order_relaxed);
+        if (queued) {
+            for (std::uint64_t idx : *queued) markCandidate(idx);
+        }
+        parallel(layout_.size(), [&](std::uint64_t begin, std::uint64_t end) {
+            Placement p;
+            for (std::uint64_t idx = begin; idx < end; ++idx) {
+                if (load(idx) != trigger) continue;
+                layout_.decode(idx, p.sq, p.stm);
+                markPredecessors(p);
+            }
+        });
+        parallel(words_, [&](std::uint64_t begin, std::uint64_t end) {
+            std::uint64_t count = 0;
+            for (std::uint64_t w = begin; w < end; ++w) {
+                for (std::uint64_t bits = candidates_[w].load(std::memory_order_relaxed); bits;) {
+                    const std::uint64_t idx = w * 64 + lsb(bits);
+                    bits &= bits - 1;
+                    const std::uint8_t before = load(idx);
+                    update(idx, k);
+                    if (before == TB_DRAW && load(idx) != TB_DRAW) ++count;
+                }
+            }
+            resolved += count;
+        });
+    };
+
+    pass(tbLoss(k - 1), nullptr);                                     // won in k
+    pass(tbWin(k), k < static_cast<int>(exitLosses_.size()) ? &exitLosses_[k] : nullptr); // lost
+    return resolved;
+}
+
+// The value a position must hold given the final values of its children
+std::uint8_t Generator::expected(const Placement& p, const Children& c) const {
+    if (c.moves == 0) return attacked(p, p.sq[p.stm == Color::WHITE ? 0 : 1], opposite(p.stm), -1) ? tbLoss(0) : TB_DRAW;
+    if (c.minLoss >= 0) return tbWin(c.minLoss + 1);
+    if (c.allWins) return tbLoss(c.maxWin);
+    return TB_DRAW;
+}
+
+std::uint64_t Generator::verify() {
+    std::atomic<std::uint64_t> bad{0};
+    std::atomic<bool> reported{false};
+    parallel(layout_.size(), [&](std::uint64_t begin, std::uint64_t end) {
+        std::uint64_t count = 0;
+        Placement p;
+        for (std::uint64_t idx = begin; idx < end; ++idx) {
+            const std::uint8_t v = load(idx);
+            if (v == TB_INVALID) continue;
+            layout_.decode(idx, p.sq, p.stm);
+            Children c;
+            children(p, false, c);
+            const std::uint8_t want = expected(p, c);
+            if (v == want) continue;
+            if (count++ == 0 && !reported.exchange(true)) {
+                std::cerr << layout_.signature() << ": position " << idx << " holds " << int(v) << ", children give "
+                          << int(want) << "\n";
+            }
+        }
+        bad += count;
+    });
+    return bad;
+}
+
+// Highest level that still has positions to propagate: wins in k are scanned at
+// level k, losses in k at level k + 1
+int Generator::highestPendingLevel() {
+    std::atomic<int> highest{0};
+    parallel(layout_.size(), [&](std::uint64_t begin, std::uint64_t end) {
+        int h = 0;
+        for (std::uint64_t idx = begin; idx < end; ++idx) {
+            const std::uint8_t v = load(idx);
+            if (tbIsWin(v)) h = std::max<int>(h, v);
+            else if (tbIsLoss(v)) h = std::max(h, v - TB_LOSS_BASE + 1);
+        }
+        for (int cur = highest.load(); h > cur && !highest.compare_exchange_weak(cur, h);) {}
+    });
+    return highest;
+}
+
+// Tables reached by captures and promotions, smallest first
+void collectDependencies(const std::string& signature, std::vector<std::string>& order, std::set<std::string>& seen) {
+    if (seen.count(signature)) return;
+    seen.insert(signature);
+    TbLayout layout;
+    if (!layout.init(signature)) return;
+    for (int removed = -1; removed < layout.pieceCount(); ++removed) {
+        if (removed == 0 || removed == 1) continue;
+        for (int promoted = -1; promoted < layout.pieceCount(); ++promoted) {
+            if (promoted == removed || (removed < 0 && promoted < 0)) continue;
+            if (promoted >= 0 && pieceType(layout.piece(promoted)) != PieceType::PAWN) continue;
+            for (int promo = 0; promo < (promoted >= 0 ? 4 : 1); ++promo) {
+                if (layout.pieceCount() - (removed >= 0) == 2) continue;
+                bool swapped;
+                collectDependencies(childSignature(layout, removed, promoted, PROMOTIONS[promo], swapped), order, seen);
+            }
+        }
+    }
+    order.push_back(signature);
+}
+
+bool generate(const Options& opt, const std::string& signature) {
+    const std::string path = (fs::path(opt.dir) / (signature + ".tb")).string();
+    if (Tablebase::add(path)) {
+        std::cout << signature << ": already complete\n";
+        return true;
+    }
+
+    TbLayout layout;
+    layout.init(signature);
+    const std::size_t bytes = sizeof(TbFileHeader) + layout.size();
+
+    // Resume a matching unfinished file, otherwise start over
+    MappedFile file;
+    TbFileHeader header{};
+    if (file.open(path, true) && file.size() == bytes) {
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (header.magic != TB_MAGIC || header.version != TB_VERSION || header.size != layout.size() ||
+            std::strncmp(header.signature, signature.c_str(), sizeof(header.signature)) != 0) {
+            header = TbFileHeader{};
+        }
+    }
+    if (header.magic != TB_MAGIC) {
+        file.close();
+        if (!file.create(path, bytes)) {
+            std::cerr << "Cannot create " << path << "\n";
+            return false;
+        }
+        header.magic = TB_MAGIC;
+        header.version = TB_VERSION;
+        std::strncpy(header.signature, signature.c_str(), sizeof(header.signature) - 1);
+        header.size = layout.size();
+    } else if (header.iteration > 0) {
+        std::cout << signature << ": resuming at level " << header.iteration << "\n";
+    }
+
+    auto saveProgress = [&](std::uint32_t iteration, bool complete) {
+        header.iteration = iteration;
+        header.complete = complete ? 1 : 0;
+        file.flush();
+        std::memcpy(file.data(), &header, sizeof(header));
+        file.flush();
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    Generator gen(layout, file.data() + sizeof(TbFileHeader), opt.threads);
+    if (!gen.prepareExits()) return false;
+    if (header.iteration == 0) {
+        gen.initialise();
+        saveProgress(1, false);
+    }
+    const int queued = gen.queueExitLosses();
+
+    int last = std::max(gen.highestPendingLevel(), queued);
+    for (int k = header.iteration; k <= std::min(last, TB_MAX_DTM + 1); ++k) {
+        const std::uint64_t resolved = gen.level(k);
+        if (resolved) last = std::max(last, gen.highestPendingLevel());
+        std::cout << signature << ": level " << k << ", " << resolved << " resolved\n";
+        saveProgress(k + 1, false);
+    }
+    const std::uint64_t bad = gen.verify();
+    if (bad) {
+        std::cerr << signature << ": " << bad << " positions disagree with their children, table left incomplete\n";
+        return false;
+    }
+    saveProgress(header.iteration, true);
+
+    std::uint64_t wins = 0, losses = 0, draws = 0;
+    int longest = 0;
+    const std::uint8_t* values = file.data() + sizeof(TbFileHeader);
+    for (std::uint64_t i = 0; i < layout.size(); ++i) {
+        if (tbIsWin(values[i])) {
+            ++wins;
+            longest = std::max<int>(longest, values[i]);
+        } else if (tbIsLoss(values[i])) ++losses;
+        else if (values[i] == TB_DRAW) ++draws;
+    }
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << signature << ": " << wins << " won, " << draws << " drawn, " << losses << " lost, longest mate "
+              << longest << " moves, " << seconds << " s -> " << path << "\n";
+
+    file.close();
+    return Tablebase::add(path);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) return 1;
+
+    std::vector<std::string> order;
+    std::set<std::string> seen;
+    for (const std::string& sig : opt.tables) {
+        TbLayout layout;
+        if (!layout.init(sig) || layout.pieceCount() < 3) {
+            std::cerr << "Bad material signature " << sig << " (expected e.g. KQvK, KRPvKR, 3-5 pieces)\n";
+            return 1;
+        }
+        // Store under the canonical name (strong side first)
+        int pieces[TB_MAX_PIECES];
+        for (int i = 0; i < layout.pieceCount(); ++i) pieces[i] = layout.piece(i);
+        bool swapped;
+        collectDependencies(tbSignature(pieces, layout.pieceCount(), swapped), order, seen);
+    }
+
+    fs::create_directories(opt.dir);
+    for (const std::string& sig : order) {
+        if (!generate(opt, sig)) return 1;
+    }
+    return 0;
+}